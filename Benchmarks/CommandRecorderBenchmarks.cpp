@@ -0,0 +1,112 @@
+//
+// CommandRecorderBenchmarks.cpp - Frame time against the number of threads recording it
+//
+
+#include <benchmark/benchmark.h>
+
+#include <barrier>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Graphics/CommandRecorder.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr uint32_t drawsPerFrame = 4096;
+   // Frames the CPU may record ahead of the null GPU.
+   constexpr uint64_t framesAhead = 2;
+
+   // Threads kept across frames, so that starting them is not measured. Run calls job(index)
+   // once on each thread and returns when all of them have finished.
+   class WorkerPool {
+    public:
+      explicit WorkerPool(uint32_t count) : start(count + 1), finish(count + 1) {
+         for (uint32_t index = 0; index < count; index++) {
+            threads.emplace_back([this, index] {
+               while (true) {
+                  start.arrive_and_wait();
+                  if (stopping) {
+                     return;
+                  }
+                  job(index);
+                  finish.arrive_and_wait();
+               }
+            });
+         }
+      }
+
+      ~WorkerPool() {
+         stopping = true;
+         start.arrive_and_wait();
+         for (auto& thread : threads) {
+            thread.join();
+         }
+      }
+
+      void Run(std::function<void(uint32_t)> work) {
+         job = std::move(work);
+         start.arrive_and_wait();
+         finish.arrive_and_wait();
+      }
+
+    private:
+      std::barrier<> start;
+      std::barrier<> finish;
+      std::function<void(uint32_t)> job;
+      bool stopping{false};
+      std::vector<std::thread> threads;
+   };
+
+   // Stands in for the state setup and culling a real draw does on the CPU before recording.
+   uint64_t PrepareDraw(uint64_t seed) noexcept {
+      for (int i = 0; i < 64; i++) {
+         seed = (seed ^ (seed >> 31)) * 0x9e3779b97f4a7c15ull;
+      }
+      return seed;
+   }
+}
+
+// The frame's draws are split evenly over the recording threads, each with its own list. Only
+// scales as far as the machine has cores.
+static void BM_ParallelRecording(benchmark::State& state) {
+   const auto threadCount = static_cast<uint32_t>(state.range(0));
+   NullDevice device;
+   Timeline timeline(device.GetQueue());
+   CommandRecorder recorder(device);
+   const auto depth = device.CreateDepthTarget(1, 1);
+   WorkerPool workers(threadCount);
+   std::vector<uint64_t> checksums(threadCount);
+
+   for (auto _ : state) {
+      recorder.BeginFrame(threadCount);
+      workers.Run([&](uint32_t index) {
+         CommandList& list = recorder.Open(index);
+         uint64_t checksum = index;
+         for (uint32_t draw = index; draw < drawsPerFrame; draw += threadCount) {
+            checksum += PrepareDraw(draw);
+            list.ClearDepth(*depth, 1.0f);
+         }
+         checksums[index] = checksum;
+      });
+      recorder.Submit(device.GetQueue(), timeline.GetNextValue());
+      const uint64_t fenceValue = timeline.Signal();
+      timeline.Wait(fenceValue > framesAhead ? fenceValue - framesAhead : 0);
+   }
+   benchmark::DoNotOptimize(checksums.data());
+   timeline.WaitForIdle();
+
+   state.SetItemsProcessed(state.iterations() * drawsPerFrame);
+   state.counters["cores"] = std::thread::hardware_concurrency();
+}
+BENCHMARK(BM_ParallelRecording)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,50 @@
+//
+// DescriptorAllocatorBenchmarks.cpp - Allocate and free churn on one allocator from many threads
+//
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "Graphics/DescriptorAllocator.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr uint32_t pageSize = 256;
+   constexpr size_t maxLivePerThread = 64;
+
+   // Shared by every thread of a run. Pages outlive runs, as they would in a renderer, and
+   // churn that frees all it allocates keeps their number bounded.
+   DescriptorAllocator& SharedAllocator() {
+      static DescriptorAllocator allocator(pageSize, [](uint32_t) {});
+      return allocator;
+   }
+}
+
+// Mostly single descriptors with the occasional table of four, each thread keeping up to 64 live
+// the way a loader thread creating and dropping views would.
+static void BM_DescriptorAllocatorChurn(benchmark::State& state) {
+   DescriptorAllocator& allocator = SharedAllocator();
+   std::mt19937 random(static_cast<uint32_t>(state.thread_index()));
+   std::vector<DescriptorRange> live;
+   live.reserve(maxLivePerThread);
+   for (auto _ : state) {
+      if (live.size() < maxLivePerThread && (live.empty() || random() % 2 == 0)) {
+         live.push_back(allocator.Allocate(random() % 8 == 0 ? 4 : 1));
+      } else {
+         const size_t pick = random() % live.size();
+         allocator.Free(live[pick]);
+         live[pick] = live.back();
+         live.pop_back();
+      }
+   }
+   for (const DescriptorRange& range : live) {
+      allocator.Free(range);
+   }
+   state.SetItemsProcessed(state.iterations());
+   state.counters["pages"] = static_cast<double>(allocator.GetPageCount());
+}
+BENCHMARK(BM_DescriptorAllocatorChurn)->ThreadRange(1, 8)->UseRealTime();
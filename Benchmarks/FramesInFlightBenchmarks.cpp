@@ -0,0 +1,64 @@
+//
+// FramesInFlightBenchmarks.cpp - Frame rate and fence stalls against frames in flight depth
+//
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <thread>
+
+#include "Graphics/NullDevice.h"
+#include "Graphics/Renderer.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   using namespace std::chrono;
+
+   constexpr auto runLength = milliseconds(500);
+   // Simulated time per recorded command, which puts a frame's GPU time in the milliseconds.
+   constexpr auto commandCost = microseconds(500);
+   // Work the CPU does per frame besides recording, about as long as the GPU's share.
+   constexpr auto cpuWork = milliseconds(3);
+}
+
+// With one frame in flight the CPU waits for the GPU every frame, so their times add up. Deeper
+// queues let the two overlap until the slower one alone sets the frame time.
+static void BM_FramesInFlight(benchmark::State& state) {
+   // No VSync to speak of, so only the CPU and GPU times matter.
+   NullDevice device({.commandCost = commandCost, .refreshInterval = microseconds(1)});
+   Renderer renderer(device);
+   renderer.Initialize(nullptr, 1280, 720);
+   renderer.SetFramesInFlight(static_cast<uint32_t>(state.range(0)));
+
+   uint64_t frames = 0;
+   uint64_t commands = 0;
+   double seconds = 0;
+   for (auto _ : state) {
+      const NullDeviceCounters before = device.GetCounters();
+      const auto start = steady_clock::now();
+      while (steady_clock::now() - start < runLength) {
+         renderer.Tick();
+         std::this_thread::sleep_for(cpuWork);
+      }
+      seconds += duration<double>(steady_clock::now() - start).count();
+      const NullDeviceCounters after = device.GetCounters();
+      frames += after.presents - before.presents;
+      commands += after.commands - before.commands;
+   }
+
+   const auto perFrame = [&](double total) {
+      return frames == 0 ? 0.0 : total / static_cast<double>(frames);
+   };
+   const FrameTimingSnapshot& timing = renderer.GetFrameTiming().ReadSnapshot();
+   state.counters["fps"] = static_cast<double>(frames) / seconds;
+   state.counters["gpu_ms"] =
+       perFrame(static_cast<double>(commands) * duration<double, std::milli>(commandCost).count());
+   state.counters["fence_wait_ms"] = timing.fenceWaitMs;
+   renderer.WaitForGpu();
+}
+BENCHMARK(BM_FramesInFlight)
+    ->DenseRange(1, Renderer::MaxFramesInFlight)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,66 @@
+//
+// LogPipelineBenchmarks.cpp - Submit throughput of the log pipeline from one or more threads
+//
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string_view>
+
+#include "System/LogPipeline.h"
+
+namespace {
+
+   constexpr std::string_view message = "Frame 1234 recorded 56 draws in 0.78 ms";
+
+   // Counts lines instead of writing them, so only the pipeline itself is measured.
+   class CountingSink : public Log::Sink {
+    public:
+      void Write(const Log::Record&, std::string_view line) override {
+         bytes += line.size();
+      }
+
+      uint64_t bytes{0};
+   };
+
+   // One pipeline shared by every run, so that starting its consumer thread is not measured.
+   struct BenchPipeline {
+      BenchPipeline() {
+         pipeline.ClearSinks();
+         pipeline.AddSink(std::make_unique<CountingSink>());
+      }
+
+      Log::Pipeline pipeline;
+   };
+
+   Log::Pipeline& GetPipeline(Log::OverflowPolicy policy) {
+      static BenchPipeline bench;
+      bench.pipeline.SetOverflowPolicy(policy);
+      return bench.pipeline;
+   }
+}
+
+// Nothing is lost, so once the queue fills producers run at the consumer's pace.
+static void BM_SubmitBlocking(benchmark::State& state) {
+   Log::Pipeline& pipeline = GetPipeline(Log::OverflowPolicy::Block);
+   for (auto _ : state) {
+      pipeline.Submit(Log::Level::Info, message);
+   }
+   pipeline.Flush();
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SubmitBlocking)->ThreadRange(1, 8)->UseRealTime();
+
+// Producers never wait; dropped is the fraction of messages the full queue turned away.
+static void BM_SubmitDropping(benchmark::State& state) {
+   Log::Pipeline& pipeline = GetPipeline(Log::OverflowPolicy::Drop);
+   uint64_t dropped = 0;
+   for (auto _ : state) {
+      dropped += pipeline.Submit(Log::Level::Info, message) ? 0 : 1;
+   }
+   pipeline.Flush();
+   state.SetItemsProcessed(state.iterations());
+   state.counters["dropped"] =
+       benchmark::Counter(static_cast<double>(dropped), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SubmitDropping)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,49 @@
+//
+// LogRateBenchmarks.cpp - Cost of the per call site rate limiter and sampler under contention
+//
+
+#include <benchmark/benchmark.h>
+
+#include "System/LogRate.h"
+
+namespace {
+
+   // One call site hit from every benchmark thread, as a hot TX_LOG_RATE_LIMITED would be.
+   Log::RateLimiter sharedLimiter;
+   Log::Sampler sharedSampler;
+}
+
+// Nearly every call is rejected, which is the case the limiter exists for. allowed is the rate
+// let through. It stays around the budget of 100 per second however many threads call, give or
+// take the one second windows a short run happens to overlap.
+static void BM_RateLimiterShared(benchmark::State& state) {
+   uint64_t allowed = 0;
+   for (auto _ : state) {
+      uint64_t suppressed = 0;
+      allowed += sharedLimiter.Allow(100, suppressed) ? 1 : 0;
+      benchmark::DoNotOptimize(suppressed);
+   }
+   state.SetItemsProcessed(state.iterations());
+   state.counters["allowed"] =
+       benchmark::Counter(static_cast<double>(allowed), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RateLimiterShared)->ThreadRange(1, 8)->UseRealTime();
+
+// The same work on a call site each thread has to itself, as the uncontended baseline.
+static void BM_RateLimiterPerThread(benchmark::State& state) {
+   Log::RateLimiter limiter;
+   for (auto _ : state) {
+      uint64_t suppressed = 0;
+      benchmark::DoNotOptimize(limiter.Allow(100, suppressed));
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RateLimiterPerThread)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_SamplerShared(benchmark::State& state) {
+   for (auto _ : state) {
+      benchmark::DoNotOptimize(sharedSampler.Allow(64));
+   }
+   state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SamplerShared)->ThreadRange(1, 8)->UseRealTime();
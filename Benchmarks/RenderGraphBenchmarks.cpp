@@ -0,0 +1,113 @@
+//
+// RenderGraphBenchmarks.cpp - Declaring and compiling a frame graph, cold and from the cache
+//
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Graphics/DeferredDeletionQueue.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/RenderGraph.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   // A frame of passes that each read two earlier resources and write a third. Every eighth
+   // resource is a transient texture, the rest are imported.
+   class GraphFixture {
+    public:
+      explicit GraphFixture(uint32_t passCount) :
+          timeline(device.GetQueue()), deletionQueue(timeline), graph(device, deletionQueue) {
+         const uint32_t resourceCount = passCount / 2 + 1;
+         for (uint32_t r = 0; r < resourceCount; r++) {
+            imported.push_back(device.CreateDepthTarget(4, 4));
+         }
+         std::mt19937 random(1);
+         const auto pick = [&] { return static_cast<uint32_t>(random() % resourceCount); };
+         for (uint32_t p = 0; p < passCount; p++) {
+            declarations.push_back({pick(), pick(), pick()});
+         }
+      }
+
+      // variant changes the topology, which makes Compile miss the cache.
+      void Declare(bool variant) {
+         graph.Reset();
+         resources.clear();
+         for (uint32_t r = 0; r < imported.size(); r++) {
+            resources.push_back(r % 8 == 0 ? graph.CreateTexture(transientDesc)
+                                           : graph.ImportTexture(*imported[r]));
+         }
+         for (uint32_t p = 0; p < declarations.size(); p++) {
+            const auto& [first, second, written] = declarations[p];
+            auto pass = graph.AddPass("Pass", [](CommandList&, const RenderGraph&) {});
+            pass.Read(resources[first], ResourceState::ShaderResource);
+            if (!(variant && p == 0)) {
+               pass.Read(resources[second], ResourceState::ShaderResource);
+            }
+            pass.Write(resources[written], ResourceState::RenderTarget).HasSideEffects();
+         }
+      }
+
+      // Lets replaced transient textures go, as the frame loop would.
+      void EndFrame() {
+         timeline.Signal();
+         deletionQueue.Collect();
+      }
+
+      NullDevice device;
+      Timeline timeline;
+      DeferredDeletionQueue deletionQueue;
+      RenderGraph graph;
+
+    private:
+      static constexpr TextureDesc transientDesc{
+          256, 256, TextureFormat::Rgba16Float, TextureUsage::RenderTarget};
+
+      std::vector<std::unique_ptr<Texture>> imported;
+      std::vector<std::array<uint32_t, 3>> declarations;
+      std::vector<RenderGraphResource> resources;
+   };
+}
+
+// Declaring the frame alone, which every frame pays whether or not Compile hits the cache.
+static void BM_RenderGraphDeclare(benchmark::State& state) {
+   GraphFixture fixture(static_cast<uint32_t>(state.range(0)));
+   for (auto _ : state) {
+      fixture.Declare(false);
+   }
+}
+BENCHMARK(BM_RenderGraphDeclare)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// The topology changes every frame, so every Compile schedules, culls and places transients.
+static void BM_RenderGraphCompileCold(benchmark::State& state) {
+   GraphFixture fixture(static_cast<uint32_t>(state.range(0)));
+   bool variant = false;
+   for (auto _ : state) {
+      variant = !variant;
+      fixture.Declare(variant);
+      fixture.graph.Compile();
+      fixture.EndFrame();
+   }
+   state.counters["compiles"] = benchmark::Counter(
+       static_cast<double>(fixture.graph.GetStats().compiles), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RenderGraphCompileCold)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// The same frame every time, so Compile only compares the topology with the cached one.
+static void BM_RenderGraphCompileCached(benchmark::State& state) {
+   GraphFixture fixture(static_cast<uint32_t>(state.range(0)));
+   for (auto _ : state) {
+      fixture.Declare(false);
+      fixture.graph.Compile();
+      fixture.EndFrame();
+   }
+   state.counters["compiles"] = benchmark::Counter(
+       static_cast<double>(fixture.graph.GetStats().compiles), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RenderGraphCompileCached)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,73 @@
+//
+// ResourceStateTrackerBenchmarks.cpp - Barriers a frame records through the trackers
+//
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Graphics/CommandRecorder.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr uint32_t textureCount = 16;
+   constexpr uint32_t usesPerList = 64;
+   constexpr std::array states = {
+       ResourceState::RenderTarget,
+       ResourceState::ShaderResource,
+       ResourceState::CopyDest,
+       ResourceState::DepthWrite,
+   };
+}
+
+// Each list requires random states for random textures, flushing before about half of them as a
+// pass boundary would. naive is what one hand written transition per use would cost; barriers
+// and batches are what the trackers actually recorded, and lists what was executed.
+static void BM_TrackedBarriers(benchmark::State& state) {
+   const auto listCount = static_cast<uint32_t>(state.range(0));
+   NullDevice device;
+   Timeline timeline(device.GetQueue());
+   CommandRecorder recorder(device);
+   std::vector<std::unique_ptr<Texture>> textures;
+   for (uint32_t i = 0; i < textureCount; i++) {
+      textures.push_back(device.CreateDepthTarget(4, 4));
+   }
+   std::mt19937 random(1);
+
+   const NullDeviceCounters before = device.GetCounters();
+   for (auto _ : state) {
+      recorder.BeginFrame(listCount);
+      for (uint32_t index = 0; index < listCount; index++) {
+         CommandList& list = recorder.Open(index);
+         ResourceStateTracker& tracker = recorder.GetStateTracker(index);
+         for (uint32_t use = 0; use < usesPerList; use++) {
+            Texture& texture = *textures[random() % textureCount];
+            tracker.Require(texture, states[random() % states.size()]);
+            if (random() % 2 == 0) {
+               tracker.Flush(list);
+               list.ClearDepth(texture, 1.0f);
+            }
+         }
+      }
+      recorder.Submit(device.GetQueue(), timeline.GetNextValue());
+      timeline.Wait(timeline.Signal());
+   }
+   timeline.WaitForIdle();
+   const NullDeviceCounters after = device.GetCounters();
+
+   const auto perFrame = [&](uint64_t total) {
+      return benchmark::Counter(static_cast<double>(total), benchmark::Counter::kAvgIterations);
+   };
+   state.counters["naive"] = perFrame(state.iterations() * listCount * usesPerList);
+   state.counters["barriers"] = perFrame(after.barriers - before.barriers);
+   state.counters["batches"] = perFrame(after.barrierBatches - before.barrierBatches);
+   state.counters["lists"] = perFrame(after.commandLists - before.commandLists);
+}
+BENCHMARK(BM_TrackedBarriers)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,85 @@
+//
+// SimulationBenchmarks.cpp - Fixed step timing jitter with the simulation inline or threaded
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "System/Simulation.h"
+
+namespace {
+
+   using namespace std::chrono;
+
+   constexpr double stepSeconds = 1.0 / 120.0;
+   constexpr auto runLength = milliseconds(400);
+   // A render loop at about 60 Hz whose every eighth frame stalls, as a blocked Present would.
+   constexpr auto frameWork = milliseconds(16);
+   constexpr uint32_t hitchEvery = 8;
+
+   // Runs a fixed step simulation next to a render loop with hitchLength long stalls, and
+   // reports how far the spacing of simulation steps strays from the fixed step.
+   void RunSimulation(benchmark::State& state, bool threaded) {
+      const auto hitchLength = milliseconds(state.range(0));
+
+      std::vector<steady_clock::time_point> steps;
+      steps.reserve(1024);
+      TX::Simulation simulation([&](const TX::StepTimer& timer, const TX::SimulationState&) {
+         steps.push_back(steady_clock::now());
+         return TX::SimulationState{.frame = timer.GetFrameCount(),
+                                    .totalSeconds = timer.GetTotalSeconds()};
+      });
+      simulation.GetTimer().SetFixedTimeStep(true);
+      simulation.GetTimer().SetTargetElapsedSeconds(stepSeconds);
+
+      for (auto _ : state) {
+         steps.clear();
+         if (threaded) {
+            simulation.Start();
+         } else {
+            simulation.GetTimer().ResetElapsedTime();
+         }
+         const auto end = steady_clock::now() + runLength;
+         for (uint32_t frame = 0; steady_clock::now() < end; frame++) {
+            if (!threaded) {
+               simulation.Tick();
+            }
+            benchmark::DoNotOptimize(simulation.Latest());
+            std::this_thread::sleep_for(frame % hitchEvery == 0 ? frameWork + hitchLength
+                                                                : frameWork);
+         }
+         simulation.Stop();
+      }
+
+      // Deviation of each gap between consecutive steps from the fixed step.
+      double sumSquares = 0;
+      double worst = 0;
+      for (size_t i = 1; i < steps.size(); i++) {
+         const double gap = duration<double>(steps[i] - steps[i - 1]).count();
+         const double error = gap - stepSeconds;
+         sumSquares += error * error;
+         worst = std::max(worst, std::abs(error));
+      }
+      const double gaps = static_cast<double>(std::max<size_t>(steps.size(), 2) - 1);
+      state.counters["steps"] = static_cast<double>(steps.size());
+      state.counters["jitter_ms"] = std::sqrt(sumSquares / gaps) * 1000.0;
+      state.counters["worst_ms"] = worst * 1000.0;
+   }
+}
+
+// Steps run in bursts from the render loop to catch up after each frame.
+static void BM_SimulationInline(benchmark::State& state) {
+   RunSimulation(state, false);
+}
+BENCHMARK(BM_SimulationInline)->Arg(0)->Arg(50)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// Steps run on their own thread, paced by its clock rather than by the render loop.
+static void BM_SimulationThreaded(benchmark::State& state) {
+   RunSimulation(state, true);
+}
+BENCHMARK(BM_SimulationThreaded)->Arg(0)->Arg(50)->Iterations(1)->Unit(benchmark::kMillisecond);
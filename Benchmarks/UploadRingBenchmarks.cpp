@@ -0,0 +1,61 @@
+//
+// UploadRingBenchmarks.cpp - Small per frame allocations through a context and the shared ring
+//
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+
+#include "Graphics/NullDevice.h"
+#include "Graphics/Timeline.h"
+#include "Graphics/UploadRing.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr uint32_t allocationsPerFrame = 4096;
+   constexpr uint64_t constantsSize = 192;
+
+   struct Fixture {
+      NullDevice device;
+      Timeline timeline{device.GetQueue()};
+      UploadRing ring{device, timeline, 4 * 1024 * 1024, 3};
+   };
+
+   // One frame of per draw constants, written as well as allocated.
+   template <typename TAllocate>
+   void RunFrames(benchmark::State& state, Fixture& fixture, TAllocate&& allocate) {
+      char constants[constantsSize] = {};
+      for (auto _ : state) {
+         fixture.ring.BeginFrame();
+         for (uint32_t draw = 0; draw < allocationsPerFrame; draw++) {
+            const UploadAllocation allocation =
+                allocate(constantsSize, UploadRing::ConstantBufferAlignment);
+            std::memcpy(allocation.data, constants, constantsSize);
+         }
+         fixture.ring.EndFrame(fixture.timeline.Signal());
+      }
+      fixture.timeline.WaitForIdle();
+      state.SetItemsProcessed(state.iterations() * allocationsPerFrame);
+   }
+}
+
+// Bumps through a chunk at a time without atomics.
+static void BM_UploadContextAllocate(benchmark::State& state) {
+   Fixture fixture;
+   UploadRing::Context context(fixture.ring);
+   RunFrames(state, fixture, [&](uint64_t size, uint64_t alignment) {
+      return context.Allocate(size, alignment);
+   });
+}
+BENCHMARK(BM_UploadContextAllocate)->Unit(benchmark::kMicrosecond);
+
+// One compare and swap on the shared head per allocation.
+static void BM_UploadRingAllocate(benchmark::State& state) {
+   Fixture fixture;
+   RunFrames(state, fixture, [&](uint64_t size, uint64_t alignment) {
+      return fixture.ring.Allocate(size, alignment);
+   });
+}
+BENCHMARK(BM_UploadRingAllocate)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,106 @@
+//
+// AliasingPlannerTests.cpp - Placement of transient resources in a shared heap
+//
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+#include "Graphics/AliasingPlanner.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr uint64_t KB = 1024;
+
+   bool LifetimesOverlap(const AliasingRequest& a, const AliasingRequest& b) {
+      return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+   }
+
+   bool MemoryOverlaps(const AliasingPlan& plan,
+                       const std::vector<AliasingRequest>& requests,
+                       size_t a,
+                       size_t b) {
+      return plan.offsets[a] < plan.offsets[b] + requests[b].size &&
+             plan.offsets[b] < plan.offsets[a] + requests[a].size;
+   }
+
+   std::vector<AliasingRequest> RandomRequests(uint32_t count, uint32_t seed) {
+      std::mt19937 random(seed);
+      std::vector<AliasingRequest> requests(count);
+      for (auto& request : requests) {
+         const uint32_t first = random() % count;
+         const uint32_t length = random() % 8;
+         request = {(1 + random() % 128) * 4 * KB,
+                    uint64_t{1} << (12 + random() % 5),
+                    first,
+                    std::min(count - 1, first + length)};
+      }
+      return requests;
+   }
+}
+
+TEST_CASE("AliasingPlanner never overlaps resources alive at the same time", "[AliasingPlanner]") {
+   AliasingPlanner planner;
+   AliasingPlan plan;
+   for (uint32_t seed = 0; seed < 50; seed++) {
+      const auto requests = RandomRequests(64, seed);
+      planner.Plan(requests, plan);
+
+      REQUIRE(plan.offsets.size() == requests.size());
+      for (size_t a = 0; a < requests.size(); a++) {
+         CHECK(plan.offsets[a] % requests[a].alignment == 0);
+         CHECK(plan.offsets[a] + requests[a].size <= plan.heapSize);
+         for (size_t b = a + 1; b < requests.size(); b++) {
+            if (LifetimesOverlap(requests[a], requests[b])) {
+               INFO("seed " << seed << " requests " << a << " and " << b);
+               CHECK_FALSE(MemoryOverlaps(plan, requests, a, b));
+            }
+         }
+      }
+      CHECK(plan.heapSize <= plan.unaliasedSize);
+   }
+}
+
+TEST_CASE("AliasingPlanner shares memory between disjoint lifetimes", "[AliasingPlanner]") {
+   const std::vector<AliasingRequest> requests = {
+       {64 * KB, 64 * KB, 0, 1},
+       {64 * KB, 64 * KB, 2, 3},
+       {32 * KB, 64 * KB, 4, 4},
+   };
+   AliasingPlanner planner;
+   AliasingPlan plan;
+   planner.Plan(requests, plan);
+
+   CHECK(plan.heapSize == 64 * KB);
+   CHECK(plan.unaliasedSize == 192 * KB);
+   CHECK(plan.offsets == std::vector<uint64_t>{0, 0, 0});
+
+   // Each later resource takes the memory over from the one before it, and the first from the
+   // last user in the previous frame.
+   REQUIRE(plan.barriers.size() == 3);
+   CHECK(plan.barriers[0].pass == 0);
+   CHECK(plan.barriers[0].after == 0);
+   CHECK(plan.barriers[0].before == AliasingPlan::NoResource);
+   CHECK(plan.barriers[1].pass == 2);
+   CHECK(plan.barriers[1].before == 0);
+   CHECK(plan.barriers[1].after == 1);
+   CHECK(plan.barriers[2].pass == 4);
+   CHECK(plan.barriers[2].after == 2);
+}
+
+TEST_CASE("AliasingPlanner stacks resources alive together", "[AliasingPlanner]") {
+   const std::vector<AliasingRequest> requests = {
+       {64 * KB, 64 * KB, 0, 2},
+       {16 * KB, 64 * KB, 1, 3},
+   };
+   AliasingPlanner planner;
+   AliasingPlan plan;
+   planner.Plan(requests, plan);
+
+   CHECK(plan.offsets == std::vector<uint64_t>{0, 64 * KB});
+   CHECK(plan.heapSize == 80 * KB);
+   CHECK(plan.barriers.empty());
+}
@@ -0,0 +1,87 @@
+//
+// BarrierTranslationTests.cpp - The sync, access and layout scope each resource state maps to
+//
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+#include "Graphics/BarrierTranslation.h"
+#include "Graphics/NullDevice.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr bool Is(ResourceState state,
+                     BarrierSync sync,
+                     BarrierAccess access,
+                     BarrierLayout layout) noexcept {
+      return ToBarrierScope(state) == BarrierScope{sync, access, layout};
+   }
+}
+
+TEST_CASE("ToBarrierScope names only the stage that uses each state", "[BarrierTranslation]") {
+   STATIC_REQUIRE(Is(ResourceState::Common,
+                     BarrierSync::All,
+                     BarrierAccess::Common,
+                     BarrierLayout::Common));
+   STATIC_REQUIRE(Is(ResourceState::Present,
+                     BarrierSync::None,
+                     BarrierAccess::NoAccess,
+                     BarrierLayout::Present));
+   STATIC_REQUIRE(Is(ResourceState::RenderTarget,
+                     BarrierSync::RenderTarget,
+                     BarrierAccess::RenderTarget,
+                     BarrierLayout::RenderTarget));
+   STATIC_REQUIRE(Is(ResourceState::DepthWrite,
+                     BarrierSync::DepthStencil,
+                     BarrierAccess::DepthStencilWrite,
+                     BarrierLayout::DepthStencilWrite));
+   STATIC_REQUIRE(Is(ResourceState::DepthRead,
+                     BarrierSync::DepthStencil,
+                     BarrierAccess::DepthStencilRead,
+                     BarrierLayout::DepthStencilRead));
+   STATIC_REQUIRE(Is(ResourceState::ShaderResource,
+                     BarrierSync::AllShading,
+                     BarrierAccess::ShaderResource,
+                     BarrierLayout::ShaderResource));
+   STATIC_REQUIRE(Is(ResourceState::UnorderedAccess,
+                     BarrierSync::AllShading,
+                     BarrierAccess::UnorderedAccess,
+                     BarrierLayout::UnorderedAccess));
+   STATIC_REQUIRE(Is(ResourceState::CopySource,
+                     BarrierSync::Copy,
+                     BarrierAccess::CopySource,
+                     BarrierLayout::CopySource));
+   STATIC_REQUIRE(Is(ResourceState::CopyDest,
+                     BarrierSync::Copy,
+                     BarrierAccess::CopyDest,
+                     BarrierLayout::CopyDest));
+}
+
+TEST_CASE("ToScopedBarrier waits only for the producing stage", "[BarrierTranslation]") {
+   STATIC_REQUIRE(ToScopedBarrier({nullptr, ResourceState::Present, ResourceState::RenderTarget}) ==
+                  ScopedTextureBarrier{
+                      nullptr,
+                      {BarrierSync::None, BarrierAccess::NoAccess, BarrierLayout::Present},
+                      {BarrierSync::RenderTarget,
+                       BarrierAccess::RenderTarget,
+                       BarrierLayout::RenderTarget}});
+   STATIC_REQUIRE(
+       ToScopedBarrier({nullptr, ResourceState::RenderTarget, ResourceState::ShaderResource}) ==
+       ScopedTextureBarrier{
+           nullptr,
+           {BarrierSync::RenderTarget, BarrierAccess::RenderTarget, BarrierLayout::RenderTarget},
+           {BarrierSync::AllShading,
+            BarrierAccess::ShaderResource,
+            BarrierLayout::ShaderResource}});
+
+   NullDevice device;
+   const std::unique_ptr<Texture> texture = device.CreateDepthTarget(4, 4);
+   const ScopedTextureBarrier barrier =
+       ToScopedBarrier({texture.get(), ResourceState::DepthWrite, ResourceState::ShaderResource});
+   CHECK(barrier.texture == texture.get());
+   CHECK(barrier.before == ToBarrierScope(ResourceState::DepthWrite));
+   CHECK(barrier.after == ToBarrierScope(ResourceState::ShaderResource));
+}
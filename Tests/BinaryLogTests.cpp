@@ -0,0 +1,118 @@
+//
+// BinaryLogTests.cpp - Writing binary logs, across reopens, and decoding them with TritonLogDecode
+//
+
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "System/BinaryLog.h"
+
+using namespace Log::Binary;
+
+namespace {
+
+   std::string ReadFile(const std::filesystem::path& path) {
+      std::ifstream input(path);
+      return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+   }
+
+   struct Decoded {
+      std::string text;
+      std::string errors;
+   };
+
+   // Runs the decoder on path and returns what it printed.
+   Decoded Decode(const std::filesystem::path& path) {
+      const std::filesystem::path text = path.string() + ".txt";
+      const std::filesystem::path errors = path.string() + ".err";
+      const std::string command = std::string{"\""} + TX_LOG_DECODE_PATH + "\" \"" +
+                                  path.string() + "\" \"" + text.string() + "\" 2> \"" +
+                                  errors.string() + "\"";
+      REQUIRE(std::system(command.c_str()) == 0);
+      Decoded decoded{ReadFile(text), ReadFile(errors)};
+      std::filesystem::remove(text);
+      std::filesystem::remove(errors);
+      return decoded;
+   }
+
+   std::filesystem::path TempPath(const char* name) {
+      return std::filesystem::temp_directory_path() / name;
+   }
+}
+
+TEST_CASE("BinaryLog messages decode back to text", "[BinaryLog]") {
+   const auto path = TempPath("BinaryLogTests-roundtrip.blog");
+   BinaryLog log;
+   REQUIRE(log.Open(path.string().c_str(), 64 * 1024));
+   static CallSite site{"Renderer.cpp", 42};
+   log.Write(site, Log::Level::Info, "Frame {} took {} ms on {}", 7, 16.5, "gpu");
+   log.Write(site, Log::Level::Info, "Frame {} took {} ms on {}", 8, 2.25, "cpu");
+   log.Close();
+
+   const Decoded decoded = Decode(path);
+   CHECK(decoded.text.find("Frame 7 took 16.5 ms on gpu (Renderer.cpp:42)") != std::string::npos);
+   CHECK(decoded.text.find("Frame 8 took 2.25 ms on cpu (Renderer.cpp:42)") != std::string::npos);
+   CHECK(decoded.errors.empty());
+   std::filesystem::remove(path);
+}
+
+TEST_CASE("BinaryLog call sites write their descriptors again after a reopen", "[BinaryLog]") {
+   const auto first = TempPath("BinaryLogTests-first.blog");
+   const auto second = TempPath("BinaryLogTests-second.blog");
+   BinaryLog log;
+   static CallSite early{"Early.cpp", 1};
+   static CallSite late{"Late.cpp", 2};
+
+   REQUIRE(log.Open(first.string().c_str(), 64 * 1024));
+   log.Write(early, Log::Level::Info, "Early {}", 1);
+   // Open closes the file it has open first.
+   REQUIRE(log.Open(second.string().c_str(), 64 * 1024));
+   log.Write(late, Log::Level::Info, "Late {}", 2);
+   log.Write(early, Log::Level::Info, "Early {}", 3);
+   log.Close();
+
+   const Decoded firstDecoded = Decode(first);
+   CHECK(firstDecoded.text.find("Early 1") != std::string::npos);
+   CHECK(firstDecoded.errors.empty());
+
+   const Decoded secondDecoded = Decode(second);
+   CHECK(secondDecoded.text.find("Late 2") != std::string::npos);
+   CHECK(secondDecoded.text.find("Early 3 (Early.cpp:1)") != std::string::npos);
+   CHECK(secondDecoded.text.find("Early 1") == std::string::npos);
+   CHECK(secondDecoded.errors.empty());
+
+   // Reopening the same path works the same way.
+   REQUIRE(log.Open(first.string().c_str(), 64 * 1024));
+   log.Write(early, Log::Level::Info, "Early {}", 4);
+   log.Close();
+   CHECK(Decode(first).text.find("Early 4") != std::string::npos);
+
+   std::filesystem::remove(first);
+   std::filesystem::remove(second);
+}
+
+TEST_CASE("BinaryLog leaves a call site unregistered if its descriptor does not fit",
+          "[BinaryLog]") {
+   const auto path = TempPath("BinaryLogTests-full.blog");
+   BinaryLog log;
+   static CallSite site{"Full.cpp", 3};
+
+   // Room for the header and nothing else.
+   REQUIRE(log.Open(path.string().c_str(), sizeof(FileHeader) + 8));
+   log.Write(site, Log::Level::Info, "Dropped {}", 1);
+   CHECK(log.GetDroppedCount() == 1);
+   CHECK(site.registration.load() == 0);
+
+   REQUIRE(log.Open(path.string().c_str(), 64 * 1024));
+   log.Write(site, Log::Level::Info, "Kept {}", 2);
+   log.Close();
+   const Decoded decoded = Decode(path);
+   CHECK(decoded.text.find("Kept 2") != std::string::npos);
+   CHECK(decoded.errors.empty());
+   std::filesystem::remove(path);
+}
@@ -0,0 +1,122 @@
+//
+// BindlessSlotTableTests.cpp - Generation checks, deferred slot reuse and generation wrap around
+//
+
+#include <catch2/catch.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+#include "Graphics/BindlessSlotTable.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   // A fence that only moves when the test says the GPU got there.
+   class ManualQueue : public Queue {
+    public:
+      void Execute(std::span<CommandList* const>) override {
+      }
+
+      void Signal(uint64_t) override {
+      }
+
+      [[nodiscard]] uint64_t GetCompletedValue() const override {
+         std::lock_guard lock(mutex);
+         return completedValue;
+      }
+
+      bool Wait(uint64_t value, std::chrono::milliseconds timeout) override {
+         std::unique_lock lock(mutex);
+         return changed.wait_for(lock, timeout, [&] { return completedValue >= value; });
+      }
+
+      void Complete(uint64_t value) {
+         {
+            std::lock_guard lock(mutex);
+            completedValue = value;
+         }
+         changed.notify_all();
+      }
+
+    private:
+      mutable std::mutex mutex;
+      std::condition_variable changed;
+      uint64_t completedValue{0};
+   };
+
+   struct Fixture {
+      ManualQueue queue;
+      Timeline timeline{queue};
+   };
+}
+
+TEST_CASE("BindlessSlotTable rejects handles of an earlier generation", "[BindlessSlotTable]") {
+   Fixture f;
+   BindlessSlotTable slots(f.timeline, 4);
+   const BindlessHandle first = slots.Allocate();
+   CHECK((first.index == 0 && first.generation == 1));
+   CHECK(slots.IsLive(first));
+   CHECK_FALSE(slots.IsLive(BindlessHandle{}));
+   CHECK_FALSE(slots.IsLive({7, 1}));
+
+   slots.Release(first);
+   CHECK_FALSE(slots.IsLive(first));
+   CHECK_THROWS_AS(slots.Release(first), std::logic_error);
+
+   f.queue.Complete(f.timeline.Signal());
+   slots.Collect();
+   const BindlessHandle reused = slots.Allocate();
+   CHECK((reused.index == first.index && reused.generation == 2));
+   CHECK(slots.IsLive(reused));
+   CHECK_FALSE(slots.IsLive(first));
+   CHECK_THROWS_AS(slots.Release(first), std::logic_error);
+   CHECK(slots.GetLiveCount() == 1);
+}
+
+TEST_CASE("BindlessSlotTable reuses a slot only once the GPU is past its release",
+          "[BindlessSlotTable]") {
+   Fixture f;
+   BindlessSlotTable slots(f.timeline, 1);
+   const BindlessHandle handle = slots.Allocate();
+   const uint64_t retireValue = f.timeline.GetNextValue();
+   slots.Release(handle);
+   CHECK(slots.GetRetiredCount() == 1);
+
+   // Not collected yet.
+   f.queue.Complete(f.timeline.Signal());
+   CHECK_THROWS_AS(slots.Allocate(), std::length_error);
+
+   slots.Collect();
+   const BindlessHandle second = slots.Allocate();
+   CHECK((second.index == 0 && second.generation == 2));
+
+   // Collected, but released with a value the GPU has not reached.
+   const uint64_t secondRetireValue = f.timeline.GetNextValue();
+   slots.Release(second);
+   CHECK(secondRetireValue > retireValue);
+   slots.Collect();
+   CHECK(slots.GetRetiredCount() == 1);
+   CHECK_THROWS_AS(slots.Allocate(), std::length_error);
+
+   f.timeline.Signal();
+   f.queue.Complete(secondRetireValue - 1);
+   slots.Collect();
+   CHECK_THROWS_AS(slots.Allocate(), std::length_error);
+
+   f.queue.Complete(secondRetireValue);
+   slots.Collect();
+   CHECK(slots.GetRetiredCount() == 0);
+   const BindlessHandle third = slots.Allocate();
+   CHECK((third.index == 0 && third.generation == 3));
+}
+
+TEST_CASE("BindlessSlotTable generations skip 0 when they wrap", "[BindlessSlotTable]") {
+   STATIC_REQUIRE(BindlessSlotTable::NextGeneration(1) == 2);
+   STATIC_REQUIRE(BindlessSlotTable::NextGeneration(UINT32_MAX - 1) == UINT32_MAX);
+   STATIC_REQUIRE(BindlessSlotTable::NextGeneration(UINT32_MAX) == 1);
+}
@@ -0,0 +1,156 @@
+//
+// CommandAllocatorPoolTests.cpp - Allocator reuse gated on the fence, trimming, and concurrent use
+//
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Graphics/CommandAllocatorPool.h"
+#include "Graphics/CommandRecorder.h"
+#include "Graphics/NullDevice.h"
+
+using namespace TX::Graphics;
+using namespace std::chrono_literals;
+
+namespace {
+
+   // Signals value on the null queue and waits for it, as if the GPU had finished that far.
+   void Complete(NullDevice& device, uint64_t value) {
+      device.GetQueue().Signal(value);
+      REQUIRE(device.GetQueue().Wait(value, 10s));
+   }
+}
+
+TEST_CASE("CommandAllocatorPool reuses an allocator only once its fence completes",
+          "[CommandAllocatorPool]") {
+   NullDevice device;
+   CommandAllocatorPool pool(device, 8);
+   const PooledCommandAllocator first = pool.Acquire();
+   CHECK(pool.GetAllocatorCount() == 1);
+   pool.Release(first, 1);
+
+   // Fence 1 has not been signalled, so the GPU may still be using it.
+   const PooledCommandAllocator second = pool.Acquire();
+   CHECK(second.id != first.id);
+   CHECK(second.allocator != first.allocator);
+   CHECK(pool.GetAllocatorCount() == 2);
+   pool.Release(second, 2);
+
+   Complete(device, 1);
+   const PooledCommandAllocator reused = pool.Acquire();
+   CHECK((reused.id == first.id && reused.allocator == first.allocator));
+   // second still waits on fence 2.
+   const PooledCommandAllocator third = pool.Acquire();
+   CHECK(third.id != second.id);
+   CHECK(pool.GetAllocatorCount() == 3);
+}
+
+TEST_CASE("CommandAllocatorPool retires allocators in release order", "[CommandAllocatorPool]") {
+   NullDevice device;
+   CommandAllocatorPool pool(device, 8);
+   const PooledCommandAllocator late = pool.Acquire();
+   const PooledCommandAllocator early = pool.Acquire();
+   pool.Release(late, 2);
+   pool.Release(early, 1);
+
+   // early is complete but queued behind late.
+   Complete(device, 1);
+   CHECK(pool.Acquire().id != early.id);
+
+   Complete(device, 2);
+   const PooledCommandAllocator next = pool.Acquire();
+   CHECK((next.id == late.id || next.id == early.id));
+   CHECK(pool.GetAllocatorCount() == 3);
+}
+
+TEST_CASE("CommandAllocatorPool throws once capacity allocators exist", "[CommandAllocatorPool]") {
+   NullDevice device;
+   CommandAllocatorPool pool(device, 2);
+   pool.Acquire();
+   const PooledCommandAllocator held = pool.Acquire();
+   CHECK_THROWS_AS(pool.Acquire(), std::runtime_error);
+   CHECK(pool.GetAllocatorCount() == 2);
+
+   // A released allocator that has completed can still be handed out.
+   pool.Release(held, 0);
+   CHECK(pool.Acquire().id == held.id);
+}
+
+TEST_CASE("CommandAllocatorPool trims only allocators idle for long enough",
+          "[CommandAllocatorPool]") {
+   NullDevice device;
+   CommandAllocatorPool pool(device, 8);
+   const PooledCommandAllocator old = pool.Acquire();
+   const PooledCommandAllocator recent = pool.Acquire();
+   const PooledCommandAllocator checkedOut = pool.Acquire();
+   const PooledCommandAllocator waiting = pool.Acquire();
+   pool.Release(old, 1);
+   pool.Release(recent, 3);
+   Complete(device, 3);
+   // Not complete, so never trimmed however long it has waited.
+   pool.Release(waiting, 10);
+
+   // old was last used 2 fence values ago and recent 0.
+   pool.Trim(1);
+   CHECK(pool.GetAllocatorCount() == 3);
+
+   const PooledCommandAllocator free = pool.Acquire();
+   CHECK((free.id == recent.id && free.allocator == recent.allocator));
+   // The trimmed node is reused, with a new allocator, before the pool grows.
+   const PooledCommandAllocator regrown = pool.Acquire();
+   CHECK(regrown.id == old.id);
+   CHECK(regrown.id != checkedOut.id);
+   CHECK(pool.GetAllocatorCount() == 4);
+
+   pool.Release(free, 3);
+   pool.Release(regrown, 3);
+   pool.Trim(CommandRecorder::MaxIdleFences);
+   CHECK(pool.GetAllocatorCount() == 4);
+}
+
+TEST_CASE("CommandAllocatorPool never hands one allocator to two threads",
+          "[CommandAllocatorPool]") {
+   constexpr uint32_t capacity = 64;
+   constexpr int threadCount = 4;
+   NullDevice device;
+   CommandAllocatorPool pool(device, capacity);
+   std::array<std::atomic<int>, capacity> users{};
+   std::atomic<bool> overlapped{false};
+
+   std::vector<std::thread> threads;
+   for (int t = 0; t < threadCount; t++) {
+      threads.emplace_back([&] {
+         for (int i = 0; i < 5000; i++) {
+            // A thread preempted inside Release holds up retirement of every release queued
+            // behind it, so the pool may briefly run out. Wait for it rather than fail.
+            std::optional<PooledCommandAllocator> acquired;
+            while (!acquired) {
+               try {
+                  acquired = pool.Acquire();
+               } catch (const std::runtime_error&) {
+                  std::this_thread::yield();
+               }
+            }
+            const PooledCommandAllocator allocator = *acquired;
+            if (users[allocator.id].fetch_add(1) != 0) {
+               overlapped = true;
+            }
+            allocator.allocator->Reset();
+            users[allocator.id].fetch_sub(1);
+            // Fence 0 is always complete, so the allocator is free again straight away.
+            pool.Release(allocator, 0);
+         }
+      });
+   }
+   for (auto& thread : threads) {
+      thread.join();
+   }
+   CHECK_FALSE(overlapped);
+}
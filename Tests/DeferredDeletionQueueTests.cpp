@@ -0,0 +1,122 @@
+//
+// DeferredDeletionQueueTests.cpp - Released objects outliving the GPU work tagged against them
+//
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Graphics/DeferredDeletionQueue.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+using namespace std::chrono_literals;
+
+namespace {
+
+   // Each command keeps the simulated GPU busy this long.
+   constexpr auto commandCost = 20ms;
+
+   // Appends its name to destroyed when it is deleted.
+   struct Tracked {
+      Tracked(std::vector<int>& destroyed, int name) : destroyed(destroyed), name(name) {
+      }
+
+      Tracked(const Tracked&) = delete;
+      Tracked& operator=(const Tracked&) = delete;
+
+      ~Tracked() {
+         destroyed.push_back(name);
+      }
+
+      std::vector<int>& destroyed;
+      int name;
+   };
+
+   struct Fixture {
+      NullDevice device{{.commandCost = commandCost}};
+      Timeline timeline{device.GetQueue()};
+      std::unique_ptr<CommandAllocator> allocator = device.CreateCommandAllocator();
+      std::unique_ptr<CommandList> list = device.CreateCommandList();
+      std::unique_ptr<Texture> depth = device.CreateDepthTarget(4, 4);
+      std::vector<int> destroyed;
+
+      // Submits commands worth of GPU work and signals the value that follows it.
+      uint64_t Submit(uint32_t commands) {
+         list->Reset(*allocator);
+         for (uint32_t n = 0; n < commands; n++) {
+            list->ClearDepth(*depth, 1.0f);
+         }
+         list->Close();
+         CommandList* lists[] = {list.get()};
+         device.GetQueue().Execute(lists);
+         return timeline.Signal();
+      }
+
+      std::unique_ptr<Tracked> Make(int name) {
+         return std::make_unique<Tracked>(destroyed, name);
+      }
+   };
+}
+
+TEST_CASE("DeferredDeletionQueue keeps an object until the timeline passes its value",
+          "[DeferredDeletionQueue]") {
+   Fixture f;
+   DeferredDeletionQueue queue(f.timeline);
+   queue.Release(f.Make(1));
+   CHECK(queue.GetPendingCount() == 1);
+
+   // Nothing has been signalled, so the work that could use it has not even been submitted.
+   queue.Collect();
+   CHECK(f.destroyed.empty());
+
+   // Tagged with the next value, which now waits behind 5 commands of GPU work.
+   const uint64_t value = f.Submit(5);
+   CHECK(value == 1);
+   queue.Collect();
+   CHECK(f.destroyed.empty());
+   CHECK(queue.GetPendingCount() == 1);
+
+   f.timeline.Wait(value);
+   queue.Collect();
+   CHECK(f.destroyed == std::vector{1});
+   CHECK(queue.GetPendingCount() == 0);
+}
+
+TEST_CASE("DeferredDeletionQueue destroys in release order", "[DeferredDeletionQueue]") {
+   Fixture f;
+   DeferredDeletionQueue queue(f.timeline);
+   const uint64_t first = f.Submit(0);
+   const uint64_t second = f.Submit(5);
+   queue.Release(f.Make(1), second);
+   queue.Release(f.Make(2), first);
+   queue.Release(f.Make(3), second);
+
+   // 2 has completed, but is held back behind 1.
+   f.timeline.Wait(first);
+   queue.Collect();
+   CHECK(f.destroyed.empty());
+   CHECK(queue.GetPendingCount() == 3);
+
+   f.timeline.Wait(second);
+   queue.Release(f.Make(4), f.timeline.GetNextValue());
+   queue.Collect();
+   CHECK(f.destroyed == std::vector{1, 2, 3});
+   CHECK(queue.GetPendingCount() == 1);
+}
+
+TEST_CASE("DeferredDeletionQueue destroys what is left when it is destroyed",
+          "[DeferredDeletionQueue]") {
+   Fixture f;
+   {
+      DeferredDeletionQueue queue(f.timeline);
+      queue.Release(std::unique_ptr<Tracked>{});
+      CHECK(queue.GetPendingCount() == 0);
+      queue.Release(f.Make(1));
+      queue.Release(f.Make(2), 100);
+   }
+   CHECK(f.destroyed == std::vector{1, 2});
+}
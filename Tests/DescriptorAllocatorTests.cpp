@@ -0,0 +1,187 @@
+//
+// DescriptorAllocatorTests.cpp - Slot ranges, page growth and reuse, from one or many threads
+//
+
+#include <catch2/catch.hpp>
+
+#include <mutex>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Graphics/DescriptorAllocator.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   using Slot = std::pair<uint32_t, uint32_t>;
+
+   DescriptorAllocator::CreatePageFunction NoPageSetup() {
+      return [](uint32_t) {};
+   }
+}
+
+TEST_CASE("DescriptorAllocator hands out single slots and ranges", "[DescriptorAllocator]") {
+   DescriptorAllocator allocator(100, NoPageSetup());
+   const DescriptorRange single = allocator.Allocate();
+   const DescriptorRange range = allocator.Allocate(70);
+   const DescriptorRange rest = allocator.Allocate(29);
+
+   CHECK((single.page == 0 && single.first == 0 && single.count == 1));
+   CHECK((range.page == 0 && range.first == 1 && range.count == 70));
+   CHECK((rest.page == 0 && rest.first == 71 && rest.count == 29));
+   CHECK(allocator.GetPageCount() == 1);
+   CHECK(allocator.GetAllocatedCount() == 100);
+
+   CHECK_THROWS_AS(allocator.Allocate(0), std::invalid_argument);
+   CHECK_THROWS_AS(allocator.Allocate(101), std::invalid_argument);
+   CHECK_THROWS_AS(allocator.Free({0, 200, 1}), std::logic_error);
+   CHECK_FALSE(DescriptorRange{}.IsValid());
+   allocator.Free(DescriptorRange{});
+}
+
+TEST_CASE("DescriptorAllocator adds pages only when existing ones are full",
+          "[DescriptorAllocator]") {
+   std::vector<uint32_t> created;
+   DescriptorAllocator allocator(64, [&](uint32_t page) { created.push_back(page); });
+   allocator.Allocate(60);
+   CHECK(created == std::vector<uint32_t>{0});
+
+   // Fits in the four slots left.
+   allocator.Allocate(4);
+   CHECK(created.size() == 1);
+
+   const DescriptorRange spilled = allocator.Allocate(1);
+   CHECK(spilled.page == 1);
+   CHECK(created == std::vector<uint32_t>{0, 1});
+   CHECK(allocator.GetPageCount() == 2);
+}
+
+TEST_CASE("DescriptorAllocator keeps its pages if page setup throws", "[DescriptorAllocator]") {
+   DescriptorAllocator allocator(1, [](uint32_t page) {
+      if (page == 1) {
+         throw std::runtime_error("out of descriptor heaps");
+      }
+   });
+   allocator.Allocate();
+   CHECK_THROWS_AS(allocator.Allocate(), std::runtime_error);
+   CHECK(allocator.GetPageCount() == 1);
+}
+
+TEST_CASE("DescriptorAllocator reuses freed slots", "[DescriptorAllocator]") {
+   DescriptorAllocator allocator(100, NoPageSetup());
+   allocator.Allocate(1);
+   const DescriptorRange middle = allocator.Allocate(70);
+   allocator.Allocate(29);
+
+   allocator.Free(middle);
+   CHECK_THROWS_AS(allocator.Free(middle), std::logic_error);
+   // Spans a bitmap word boundary.
+   const DescriptorRange reused = allocator.Allocate(64);
+   CHECK((reused.page == 0 && reused.first == 1));
+   const DescriptorRange after = allocator.Allocate(1);
+   CHECK((after.page == 0 && after.first == 65));
+   CHECK(allocator.GetPageCount() == 1);
+}
+
+TEST_CASE("DescriptorAllocator finds ranges in a fragmented page", "[DescriptorAllocator]") {
+   DescriptorAllocator allocator(256, NoPageSetup());
+   std::vector<DescriptorRange> slots;
+   for (int i = 0; i < 256; i++) {
+      slots.push_back(allocator.Allocate());
+   }
+   for (int i = 0; i < 256; i += 2) {
+      allocator.Free(slots[i]);
+   }
+   allocator.Free(slots[201]);
+
+   // 200, 201 and 202 are the only three free slots in a row.
+   const DescriptorRange three = allocator.Allocate(3);
+   CHECK((three.page == 0 && three.first == 200));
+   CHECK(allocator.Allocate(2).page == 1);
+}
+
+TEST_CASE("DescriptorAllocator matches a reference under random use", "[DescriptorAllocator]") {
+   DescriptorAllocator allocator(128, NoPageSetup());
+   std::mt19937 random(5);
+   std::vector<DescriptorRange> live;
+   std::set<Slot> used;
+   bool unique = true;
+   for (int i = 0; i < 20000; i++) {
+      if (live.empty() || random() % 2 == 0) {
+         const DescriptorRange range = allocator.Allocate(1 + random() % 16);
+         REQUIRE(range.first + range.count <= 128);
+         for (uint32_t slot = 0; slot < range.count; slot++) {
+            unique = used.insert({range.page, range.first + slot}).second && unique;
+         }
+         live.push_back(range);
+      } else {
+         const size_t pick = random() % live.size();
+         const DescriptorRange range = live[pick];
+         live[pick] = live.back();
+         live.pop_back();
+         for (uint32_t slot = 0; slot < range.count; slot++) {
+            used.erase({range.page, range.first + slot});
+         }
+         allocator.Free(range);
+      }
+   }
+   CHECK(unique);
+   CHECK(allocator.GetAllocatedCount() == used.size());
+}
+
+TEST_CASE("DescriptorAllocator never hands a slot to two threads", "[DescriptorAllocator]") {
+   constexpr int threadCount = 4;
+   DescriptorAllocator allocator(64, NoPageSetup());
+   std::mutex mutex;
+   std::set<Slot> used;
+   bool unique = true;
+
+   std::vector<std::thread> threads;
+   for (int t = 0; t < threadCount; t++) {
+      threads.emplace_back([&, t] {
+         std::mt19937 random(t);
+         std::vector<DescriptorRange> live;
+         for (int i = 0; i < 5000; i++) {
+            if (live.size() < 48 && (live.empty() || random() % 2 == 0)) {
+               const DescriptorRange range = allocator.Allocate(random() % 8 == 0 ? 4 : 1);
+               const std::lock_guard lock(mutex);
+               for (uint32_t slot = 0; slot < range.count; slot++) {
+                  unique = used.insert({range.page, range.first + slot}).second && unique;
+               }
+               live.push_back(range);
+            } else {
+               const size_t pick = random() % live.size();
+               const DescriptorRange range = live[pick];
+               live[pick] = live.back();
+               live.pop_back();
+               {
+                  const std::lock_guard lock(mutex);
+                  for (uint32_t slot = 0; slot < range.count; slot++) {
+                     used.erase({range.page, range.first + slot});
+                  }
+               }
+               allocator.Free(range);
+            }
+         }
+         for (const DescriptorRange& range : live) {
+            {
+               const std::lock_guard lock(mutex);
+               for (uint32_t slot = 0; slot < range.count; slot++) {
+                  used.erase({range.page, range.first + slot});
+               }
+            }
+            allocator.Free(range);
+         }
+      });
+   }
+   for (auto& thread : threads) {
+      thread.join();
+   }
+   CHECK(unique);
+   CHECK(allocator.GetAllocatedCount() == 0);
+}
@@ -0,0 +1,67 @@
+//
+// DescriptorTableRingTests.cpp - Table staging, deduplication within a frame and partition reuse
+//
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <stdexcept>
+
+#include "Graphics/DescriptorTableRing.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr uint32_t slotsPerFrame = 16;
+
+   struct Fixture {
+      NullDevice device;
+      Timeline timeline{device.GetQueue()};
+      DescriptorTableRing ring{timeline, slotsPerFrame, 2};
+   };
+}
+
+TEST_CASE("DescriptorTableRing stages a table once per frame", "[DescriptorTableRing]") {
+   Fixture f;
+   const std::array<uint64_t, 3> material{10, 11, 12};
+   const std::array<uint64_t, 2> other{10, 11};
+
+   f.ring.BeginFrame();
+   const uint32_t first = f.ring.Stage(material);
+   const uint32_t second = f.ring.Stage(other);
+   CHECK(f.ring.Stage(material) == first);
+   CHECK(second == first + 3);
+
+   const auto copies = f.ring.TakeCopies();
+   REQUIRE(copies.size() == 2);
+   CHECK((copies[0].firstSlot == first && copies[0].firstSource == 0 && copies[0].count == 3));
+   CHECK((copies[1].firstSlot == second && copies[1].firstSource == 3 && copies[1].count == 2));
+   CHECK(f.ring.TakeCopies().empty());
+   CHECK(f.ring.GetStats().tables == 2);
+   CHECK(f.ring.GetStats().cacheHits == 1);
+   CHECK(f.ring.GetStats().descriptorsCopied == 5);
+   f.ring.EndFrame(f.timeline.Signal());
+
+   // The next frame uses the other partition and stages the table again.
+   f.ring.BeginFrame();
+   CHECK(f.ring.Stage(material) == slotsPerFrame);
+   CHECK(f.ring.TakeCopies().size() == 1);
+   f.ring.EndFrame(f.timeline.Signal());
+   f.timeline.WaitForIdle();
+}
+
+TEST_CASE("DescriptorTableRing throws once a frame's partition is full", "[DescriptorTableRing]") {
+   Fixture f;
+   const std::array<uint64_t, 10> big{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+   const std::array<uint64_t, 7> tooBig{21, 22, 23, 24, 25, 26, 27};
+   f.ring.BeginFrame();
+   f.ring.Stage(big);
+   CHECK_THROWS_AS(f.ring.Stage(tooBig), std::length_error);
+   // A repeat needs no slots.
+   CHECK(f.ring.Stage(big) == 0);
+   f.ring.EndFrame(f.timeline.Signal());
+   f.timeline.WaitForIdle();
+}
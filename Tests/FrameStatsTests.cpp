@@ -0,0 +1,179 @@
+//
+// FrameStatsTests.cpp - Frame time percentiles, jitter and window rotation from known distributions
+//
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+#include "FrameStats.h"
+#include "StepTimer.h"
+
+using namespace TX;
+
+namespace {
+
+   using Histogram = FrameStats::DeltaHistogram;
+   using ManualTimer = BasicStepTimer<ManualClock>;
+
+   constexpr uint64_t second = ManualTimer::TicksPerSecond;
+   constexpr uint64_t millisecond = second / 1000;
+
+   // A reported percentile is the upper bound of the bucket holding the true value, so it may be
+   // high by up to the histogram's 1/16 relative precision.
+   bool IsBucketOf(uint64_t reported, uint64_t actual) {
+      return reported >= actual && reported <= actual + actual / Histogram::SubBucketCount;
+   }
+
+   // Advances the clock by delta and ticks once.
+   void Frame(ManualTimer& timer, uint64_t delta) {
+      timer.GetClock().Advance(delta);
+      timer.Tick([] {});
+   }
+}
+
+TEST_CASE("LogLinearHistogram buckets are exact below the sub-bucket count", "[FrameStats]") {
+   STATIC_REQUIRE(Histogram::BucketIndex(0) == 0);
+   STATIC_REQUIRE(Histogram::BucketIndex(15) == 15);
+   STATIC_REQUIRE(Histogram::BucketIndex(16) == 16);
+   STATIC_REQUIRE(Histogram::BucketIndex(31) == 31);
+   STATIC_REQUIRE(Histogram::BucketIndex(15) != Histogram::BucketIndex(16));
+   // Above 32 each bucket spans two values, above 64 four.
+   STATIC_REQUIRE(Histogram::BucketIndex(32) == Histogram::BucketIndex(33));
+   STATIC_REQUIRE(Histogram::BucketIndex(33) != Histogram::BucketIndex(34));
+   STATIC_REQUIRE(Histogram::BucketUpperBound(Histogram::BucketIndex(64)) == 67);
+   STATIC_REQUIRE(Histogram::BucketIndex(uint64_t{1} << 40) == Histogram::BucketCount - 1);
+}
+
+TEST_CASE("LogLinearHistogram bounds every value within its relative precision",
+          "[FrameStats]") {
+   for (uint64_t value = 1; value < (uint64_t{1} << 32); value = value * 3 + 1) {
+      const uint32_t index = Histogram::BucketIndex(value);
+      CHECK(IsBucketOf(Histogram::BucketUpperBound(index), value));
+      CHECK(Histogram::BucketUpperBound(index - 1) < value);
+   }
+}
+
+TEST_CASE("LogLinearHistogram reports percentiles of a uniform distribution", "[FrameStats]") {
+   Histogram histogram;
+   CHECK(histogram.GetPercentile(0.5) == 0);
+   for (uint64_t value = 1; value <= 1000; value++) {
+      histogram.Record(value);
+   }
+   CHECK(histogram.GetCount() == 1000);
+   CHECK((histogram.GetMin() == 1 && histogram.GetMax() == 1000));
+   CHECK(histogram.GetMean() == Approx(500.5));
+   CHECK(histogram.GetStdDev() == Approx(std::sqrt((1000.0 * 1000.0 - 1.0) / 12.0)));
+   CHECK(IsBucketOf(histogram.GetPercentile(0.50), 500));
+   CHECK(IsBucketOf(histogram.GetPercentile(0.95), 950));
+   CHECK(IsBucketOf(histogram.GetPercentile(0.99), 990));
+   // Clamped to the largest value seen rather than reported as its bucket's bound.
+   CHECK(histogram.GetPercentile(1.0) == 1000);
+
+   Histogram other;
+   other.Record(5000);
+   histogram.Merge(other);
+   CHECK(histogram.GetCount() == 1001);
+   CHECK(histogram.GetPercentile(1.0) == 5000);
+   CHECK(IsBucketOf(histogram.GetPercentile(0.50), 501));
+}
+
+TEST_CASE("FrameStats reports the percentiles of frames fed through StepTimer", "[FrameStats]") {
+   ManualTimer timer;
+   // Each quarter second sub-window: 40 frames of 5 ms, then one 50 ms hitch.
+   for (int window = 0; window < 4; window++) {
+      for (int frame = 0; frame < 40; frame++) {
+         Frame(timer, 5 * millisecond);
+      }
+      Frame(timer, 50 * millisecond);
+   }
+
+   const FrameTimeSnapshot& snapshot = timer.GetFrameStats().ReadSnapshot();
+   CHECK(snapshot.sequence == 4);
+   CHECK(snapshot.windowTicks == second);
+   const Distribution& delta = snapshot.tickDelta;
+   CHECK(delta.count == 164);
+   CHECK((delta.min == 5 * millisecond && delta.max == 50 * millisecond));
+   CHECK(IsBucketOf(delta.p50, 5 * millisecond));
+   CHECK(IsBucketOf(delta.p95, 5 * millisecond));
+   // Only 4 of 164 frames hitch, but that is more than the slowest 1 percent.
+   CHECK(delta.p99 == 50 * millisecond);
+   CHECK(delta.p999 == 50 * millisecond);
+
+   const double mean = (160.0 * 5 + 4.0 * 50) / 164 * millisecond;
+   const double meanOfSquares = (160.0 * 5 * 5 + 4.0 * 50 * 50) / 164 * millisecond * millisecond;
+   CHECK(delta.mean == Approx(mean));
+   CHECK(delta.stdDev == Approx(std::sqrt(meanOfSquares - mean * mean)));
+
+   // Variable steps run one update per tick.
+   CHECK((snapshot.updatesPerTick.min == 1 && snapshot.updatesPerTick.max == 1));
+}
+
+TEST_CASE("FrameStats measures jitter as the standard deviation of frame times",
+          "[FrameStats]") {
+   ManualTimer timer;
+   for (int frame = 0; frame < 25; frame++) {
+      Frame(timer, 10 * millisecond);
+   }
+   const Distribution steady = timer.GetFrameStats().ReadSnapshot().tickDelta;
+   CHECK(steady.count == 25);
+   CHECK(steady.stdDev == 0.0);
+   CHECK(steady.p50 == 10 * millisecond);
+   CHECK(steady.p99 == 10 * millisecond);
+
+   // Same mean frame time, but alternating 8 and 12 ms. 26 frames close the sub-window.
+   timer.ResetElapsedTime();
+   for (int frame = 0; frame < 26; frame++) {
+      Frame(timer, (frame % 2 == 0 ? 8 : 12) * millisecond);
+   }
+   const Distribution alternating = timer.GetFrameStats().ReadSnapshot().tickDelta;
+   CHECK(alternating.count == 26);
+   CHECK(alternating.mean == Approx(10.0 * millisecond));
+   CHECK(alternating.stdDev == Approx(2.0 * millisecond));
+   CHECK(IsBucketOf(alternating.p50, 8 * millisecond));
+   CHECK(alternating.p99 == 12 * millisecond);
+}
+
+TEST_CASE("FrameStats rotates old sub-windows out of the window", "[FrameStats]") {
+   FrameStats stats(400);
+   CHECK(stats.GetWindowTicks() == 400);
+
+   // Samples shorter than a sub-window accumulate until it closes.
+   stats.Record(30, 1);
+   stats.Record(30, 1);
+   stats.Record(30, 1);
+   CHECK(stats.ReadSnapshot().sequence == 0);
+   stats.Record(30, 1);
+   CHECK(stats.ReadSnapshot().sequence == 1);
+   CHECK(stats.ReadSnapshot().tickDelta.count == 4);
+
+   for (int n = 0; n < 3; n++) {
+      stats.Record(100, 2);
+   }
+   CHECK(stats.ReadSnapshot().sequence == 4);
+   CHECK(stats.ReadSnapshot().tickDelta.count == 7);
+
+   // The fifth sub-window replaces the first.
+   stats.Record(200, 3);
+   FrameTimeSnapshot snapshot = stats.ReadSnapshot();
+   CHECK(snapshot.sequence == 5);
+   CHECK(snapshot.tickDelta.count == 4);
+   CHECK((snapshot.tickDelta.min == 100 && snapshot.tickDelta.max == 200));
+   CHECK((snapshot.updatesPerTick.min == 2 && snapshot.updatesPerTick.max == 3));
+
+   for (int n = 0; n < 3; n++) {
+      stats.Record(200, 3);
+   }
+   snapshot = stats.ReadSnapshot();
+   CHECK(snapshot.tickDelta.count == 4);
+   CHECK(snapshot.tickDelta.min == 200);
+   CHECK(snapshot.tickDelta.stdDev == 0.0);
+
+   // Reset empties the window; the next publish only holds what came after it.
+   stats.Reset();
+   stats.Record(100, 1);
+   snapshot = stats.ReadSnapshot();
+   CHECK(snapshot.sequence == 9);
+   CHECK(snapshot.tickDelta.count == 1);
+}
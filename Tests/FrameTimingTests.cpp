@@ -0,0 +1,82 @@
+//
+// FrameTimingTests.cpp - Classifying frames as CPU, GPU or VSync bound over a rolling window
+//
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+
+#include "Graphics/FrameTiming.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   // Clock counts are microseconds here, so a 60Hz refresh is 16667.
+   constexpr uint64_t frequency = 1'000'000;
+   constexpr uint64_t refresh = 16'667;
+}
+
+TEST_CASE("FrameTiming classifies unblocked frames as CPU bound", "[FrameTiming]") {
+   STATIC_REQUIRE(FrameTiming::Classify(0, 0, 0, refresh) == FrameBound::Unknown);
+   STATIC_REQUIRE(FrameTiming::Classify(25'000, 0, 0, refresh) == FrameBound::Cpu);
+   // Waits under a tenth of the frame are noise, even at the refresh rate.
+   STATIC_REQUIRE(FrameTiming::Classify(refresh, 1'600, 1'600, refresh) == FrameBound::Cpu);
+   STATIC_REQUIRE(FrameTiming::Classify(8'000, 700, 0, 0) == FrameBound::Cpu);
+}
+
+TEST_CASE("FrameTiming classifies blocked frames slower than the display as GPU bound",
+          "[FrameTiming]") {
+   STATIC_REQUIRE(FrameTiming::Classify(30'000, 15'000, 0, refresh) == FrameBound::Gpu);
+   // Where the frame blocks does not matter once the refresh interval is known.
+   STATIC_REQUIRE(FrameTiming::Classify(30'000, 0, 15'000, refresh) == FrameBound::Gpu);
+   // Just over the tolerance.
+   STATIC_REQUIRE(FrameTiming::Classify(17'600, 5'000, 0, refresh) == FrameBound::Gpu);
+   // Without a refresh interval the larger wait decides.
+   STATIC_REQUIRE(FrameTiming::Classify(30'000, 15'000, 2'000, 0) == FrameBound::Gpu);
+}
+
+TEST_CASE("FrameTiming classifies blocked frames keeping up with the display as VSync bound",
+          "[FrameTiming]") {
+   // A swap chain waiting on the display shows up as a fence wait.
+   STATIC_REQUIRE(FrameTiming::Classify(refresh, 12'000, 0, refresh) == FrameBound::VSync);
+   STATIC_REQUIRE(FrameTiming::Classify(refresh, 0, 12'000, refresh) == FrameBound::VSync);
+   // Within the tolerance above the interval.
+   STATIC_REQUIRE(FrameTiming::Classify(17'400, 5'000, 0, refresh) == FrameBound::VSync);
+   STATIC_REQUIRE(FrameTiming::Classify(30'000, 2'000, 15'000, 0) == FrameBound::VSync);
+}
+
+TEST_CASE("FrameTiming averages over the last WindowFrames frames", "[FrameTiming]") {
+   FrameTiming timing(frequency);
+   timing.SetRefreshInterval(refresh);
+   CHECK(timing.Summarize().bound == FrameBound::Unknown);
+
+   for (uint32_t n = 0; n < FrameTiming::WindowFrames; n++) {
+      timing.Record({.frame = 30'000, .fenceWait = 20'000, .presentWait = 0});
+   }
+   FrameTimingSnapshot snapshot = timing.Summarize();
+   CHECK(snapshot.frameCount == FrameTiming::WindowFrames);
+   CHECK(snapshot.frameMs == Approx(30.0));
+   CHECK(snapshot.cpuMs == Approx(10.0));
+   CHECK(snapshot.fenceWaitMs == Approx(20.0));
+   CHECK(snapshot.bound == FrameBound::Gpu);
+
+   // A full window of fast frames pushes the slow ones out entirely.
+   for (uint32_t n = 0; n < FrameTiming::WindowFrames; n++) {
+      timing.Record({.frame = 5'000, .fenceWait = 0, .presentWait = 0});
+   }
+   snapshot = timing.Summarize();
+   CHECK(snapshot.frameMs == Approx(5.0));
+   CHECK(snapshot.fenceWaitMs == Approx(0.0));
+   CHECK(snapshot.bound == FrameBound::Cpu);
+   CHECK(timing.ReadSnapshot().sequence == snapshot.sequence);
+}
+
+TEST_CASE("FrameTiming clamps waits to the frame they were measured in", "[FrameTiming]") {
+   FrameTiming timing(frequency);
+   timing.Record({.frame = 10'000, .fenceWait = 8'000, .presentWait = 8'000});
+   const FrameTimingSnapshot snapshot = timing.Summarize();
+   CHECK(snapshot.fenceWaitMs == Approx(8.0));
+   CHECK(snapshot.presentWaitMs == Approx(2.0));
+   CHECK(snapshot.cpuMs == Approx(0.0));
+}
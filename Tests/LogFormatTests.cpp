@@ -0,0 +1,63 @@
+//
+// LogFormatTests.cpp - Text written by AppendValue for each kind of value
+//
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "System/LogFormat.h"
+
+namespace {
+
+   enum class Color : uint8_t {
+      Blue = 3,
+   };
+
+   template <typename T>
+   std::string Text(const T& value) {
+      Log::FixedString<64> out;
+      Log::AppendValue(out, value);
+      return std::string{out.View()};
+   }
+}
+
+TEST_CASE("LogFormat writes numbers as std::format would", "[LogFormat]") {
+   CHECK(Text(42) == "42");
+   CHECK(Text(-7LL) == "-7");
+   CHECK(Text(uint64_t{18446744073709551615u}) == "18446744073709551615");
+   CHECK(Text(0.1) == "0.1");
+   CHECK(Text(0.1f) == "0.1");
+   CHECK(Text(-1.5) == "-1.5");
+   CHECK(Text(Color::Blue) == "3");
+}
+
+TEST_CASE("LogFormat writes bools and characters as text", "[LogFormat]") {
+   CHECK(Text(true) == "true");
+   CHECK(Text(false) == "false");
+   CHECK(Text('x') == "x");
+   CHECK(Text(L'y') == "y");
+}
+
+TEST_CASE("LogFormat writes pointers in hex", "[LogFormat]") {
+   CHECK(Text(reinterpret_cast<const void*>(uintptr_t{0x1f0})) == "0x1f0");
+   CHECK(Text(static_cast<const char*>(nullptr)) == "(null)");
+}
+
+TEST_CASE("LogFormat encodes wide strings as UTF-8", "[LogFormat]") {
+   CHECK(Text(L"café") == "caf\xc3\xa9");
+   CHECK(Text(std::wstring_view{L"\U0001F600"}) == "\xf0\x9f\x98\x80");
+}
+
+TEST_CASE("LogFormat writes suppressed count only when non zero", "[LogFormat]") {
+   CHECK(Text(Log::Suppressed{0}) == "");
+   CHECK(Text(Log::Suppressed{12}) == "[12 suppressed] ");
+}
+
+TEST_CASE("LogFormat truncates at capacity", "[LogFormat]") {
+   Log::FixedString<4> out;
+   Log::AppendValue(out, 123456);
+   CHECK(out.View() == "1234");
+   Log::AppendValue(out, "more");
+   CHECK(out.View() == "1234");
+}
@@ -0,0 +1,84 @@
+//
+// LoggerTests.cpp - Lines streamed from many threads at once reach the sinks whole
+//
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Logger.h"
+
+namespace {
+
+   class CollectingSink : public Log::Sink {
+    public:
+      void Write(const Log::Record& record, std::string_view) override {
+         const std::lock_guard lock(mutex);
+         texts.emplace_back(record.Text());
+      }
+
+      std::vector<std::string> Take() {
+         const std::lock_guard lock(mutex);
+         return std::exchange(texts, {});
+      }
+
+    private:
+      std::mutex mutex;
+      std::vector<std::string> texts;
+   };
+}
+
+TEST_CASE("Logger keeps lines from concurrent threads whole", "[Logger]") {
+   Log::Pipeline& pipeline = Log::GetPipeline();
+   pipeline.ClearSinks();
+   auto owned = std::make_unique<CollectingSink>();
+   CollectingSink& sink = *owned;
+   pipeline.AddSink(std::move(owned));
+   pipeline.SetOverflowPolicy(Log::OverflowPolicy::Block);
+
+   constexpr int threadCount = 16;
+   constexpr int linesPerThread = 1000;
+   std::vector<std::thread> threads;
+   for (int t = 0; t < threadCount; t++) {
+      threads.emplace_back([t] {
+         for (int i = 0; i < linesPerThread; i++) {
+            // Streamed a piece at a time so that other threads get between the pieces.
+            Log::info << "thread " << t << " line " << i;
+            std::this_thread::yield();
+            Log::info << " value " << t * 100000 + i << " end" << std::endl;
+         }
+      });
+   }
+   for (auto& thread : threads) {
+      thread.join();
+   }
+   pipeline.Flush();
+
+   const std::vector<std::string> lines = sink.Take();
+   CHECK(lines.size() == threadCount * linesPerThread);
+   std::set<std::pair<int, int>> seen;
+   size_t malformed = 0;
+   for (const std::string& line : lines) {
+      int t = -1;
+      int i = -1;
+      int value = -1;
+      char end[4] = {};
+      const bool parsed =
+          std::sscanf(line.c_str(), "thread %d line %d value %d %3s", &t, &i, &value, end) == 4;
+      const std::string expected = "thread " + std::to_string(t) + " line " + std::to_string(i) +
+                                   " value " + std::to_string(t * 100000 + i) + " end";
+      if (!parsed || line != expected || !seen.insert({t, i}).second) {
+         malformed++;
+      }
+   }
+   CHECK(malformed == 0);
+   CHECK(seen.size() == threadCount * linesPerThread);
+   CHECK(pipeline.GetDroppedCount() == 0);
+}
@@ -0,0 +1,6 @@
+//
+// Main.cpp - Entry point shared by the test executables
+//
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
@@ -0,0 +1,224 @@
+//
+// RenderGraphTests.cpp - Culling, the compiled schedule cache, transitions and queue waits
+//
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "Graphics/DeferredDeletionQueue.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/RenderGraph.h"
+#include "Graphics/ResourceStateTracker.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr TextureDesc transientDesc{
+       64, 64, TextureFormat::Rgba16Float, TextureUsage::RenderTarget};
+
+   struct Fixture {
+      NullDevice device;
+      Timeline timeline{device.GetQueue()};
+      DeferredDeletionQueue deletionQueue{timeline};
+      RenderGraph graph{device, deletionQueue};
+      std::unique_ptr<Texture> a = device.CreateDepthTarget(4, 4);
+      std::unique_ptr<Texture> b = device.CreateDepthTarget(4, 4);
+      std::vector<std::string_view> executed;
+
+      ~Fixture() {
+         timeline.WaitForIdle();
+         deletionQueue.Collect();
+      }
+
+      // A pass that only notes that it ran.
+      RenderGraphPassBuilder AddPass(std::string_view name, PassQueue queue = PassQueue::Graphics) {
+         return graph.AddPass(
+             name, [this, name](CommandList&, const RenderGraph&) { executed.push_back(name); },
+             queue);
+      }
+
+      // Executes on a fresh list with a leading tracker, so that every transition, including
+      // the first one of each texture, is recorded in the list.
+      std::vector<NullCommand> Execute() {
+         NullCommandAllocator allocator;
+         NullCommandList list;
+         ResourceStateTracker states;
+         states.Reset(true);
+         list.Reset(allocator);
+         graph.Execute(list, states);
+         states.Flush(list);
+         list.Close();
+         return {list.GetCommands().begin(), list.GetCommands().end()};
+      }
+
+      [[nodiscard]] std::vector<std::string_view> ScheduledNames() const {
+         std::vector<std::string_view> names;
+         for (const auto& compiled : graph.GetSchedule()) {
+            names.push_back(graph.GetPassName(compiled.pass));
+         }
+         return names;
+      }
+   };
+
+   bool IsTransition(const NullCommand& command,
+                     const Texture& texture,
+                     ResourceState before,
+                     ResourceState after) {
+      return command.op == NullCommand::Op::Transition && command.target == &texture &&
+             command.before == before && command.after == after;
+   }
+}
+
+TEST_CASE("RenderGraph culls passes that contribute to no output", "[RenderGraph]") {
+   Fixture f;
+   const auto a = f.graph.ImportTexture(*f.a);
+   const auto b = f.graph.ImportTexture(*f.b);
+   const auto scratch = f.graph.CreateTexture(transientDesc);
+   f.AddPass("Unused").Write(b, ResourceState::RenderTarget);
+   f.AddPass("Produce").Write(scratch, ResourceState::RenderTarget);
+   f.AddPass("Consume")
+       .Read(scratch, ResourceState::ShaderResource)
+       .Write(a, ResourceState::RenderTarget);
+   f.AddPass("Readback").Read(b, ResourceState::CopySource).HasSideEffects();
+   f.AddPass("Overwritten").Write(a, ResourceState::DepthWrite);
+   f.AddPass("Final").Read(a, ResourceState::ShaderResource).Write(a, ResourceState::RenderTarget);
+   f.graph.SetOutput(a, ResourceState::ShaderResource);
+   f.graph.Compile();
+
+   // Final reads what Overwritten wrote, which only partly overwrites what Consume wrote. The
+   // side effect pass keeps Unused, whose output it reads.
+   CHECK(f.ScheduledNames() ==
+         std::vector<std::string_view>{
+             "Unused", "Produce", "Consume", "Readback", "Overwritten", "Final"});
+   CHECK(f.graph.GetStats().culledPasses == 0);
+
+   f.graph.Reset();
+   const auto a2 = f.graph.ImportTexture(*f.a);
+   const auto b2 = f.graph.ImportTexture(*f.b);
+   f.AddPass("Unused").Write(b2, ResourceState::RenderTarget);
+   f.AddPass("Dead").Read(b2, ResourceState::ShaderResource);
+   f.AddPass("Kept").Write(a2, ResourceState::RenderTarget);
+   f.AddPass("Effect").HasSideEffects();
+   f.graph.SetOutput(a2, ResourceState::Present);
+   f.graph.Compile();
+   CHECK(f.ScheduledNames() == std::vector<std::string_view>{"Kept", "Effect"});
+   CHECK(f.graph.GetStats().culledPasses == 2);
+
+   f.Execute();
+   CHECK(f.executed == std::vector<std::string_view>{"Kept", "Effect"});
+}
+
+TEST_CASE("RenderGraph reuses the schedule while the topology is unchanged", "[RenderGraph]") {
+   Fixture f;
+   const auto declare = [&](Texture& target, ResourceState readState) {
+      f.graph.Reset();
+      const auto resource = f.graph.ImportTexture(target);
+      const auto scratch = f.graph.CreateTexture(transientDesc);
+      f.AddPass("Draw").Write(scratch, ResourceState::RenderTarget);
+      f.AddPass("Post").Read(scratch, readState).Write(resource, ResourceState::RenderTarget);
+      f.graph.SetOutput(resource, ResourceState::Present);
+      f.graph.Compile();
+   };
+
+   declare(*f.a, ResourceState::ShaderResource);
+   CHECK((f.graph.GetStats().compiles == 1 && f.graph.GetStats().cacheHits == 0));
+   Texture* transient = &f.graph.GetTexture({1});
+
+   // Another imported texture is not a different topology, and the transient is kept.
+   declare(*f.b, ResourceState::ShaderResource);
+   CHECK((f.graph.GetStats().compiles == 1 && f.graph.GetStats().cacheHits == 1));
+   CHECK(&f.graph.GetTexture({0}) == f.b.get());
+   CHECK(&f.graph.GetTexture({1}) == transient);
+
+   declare(*f.b, ResourceState::CopySource);
+   CHECK((f.graph.GetStats().compiles == 2 && f.graph.GetStats().cacheHits == 1));
+   // The old transient went to the deletion queue, as frames in flight may still use it.
+   CHECK(f.deletionQueue.GetPendingCount() > 0);
+}
+
+TEST_CASE("RenderGraph transitions only where a texture's state changes", "[RenderGraph]") {
+   Fixture f;
+   const auto a = f.graph.ImportTexture(*f.a);
+   f.AddPass("First").Write(a, ResourceState::RenderTarget);
+   f.AddPass("Second").Write(a, ResourceState::RenderTarget);
+   f.AddPass("Sample").Read(a, ResourceState::ShaderResource).HasSideEffects();
+   f.AddPass("SampleAgain").Read(a, ResourceState::ShaderResource).HasSideEffects();
+   f.graph.SetOutput(a, ResourceState::CopySource);
+   f.graph.Compile();
+
+   const auto& schedule = f.graph.GetSchedule();
+   REQUIRE(schedule.size() == 4);
+   CHECK(schedule[0].transitionCount == 1);
+   CHECK(schedule[1].transitionCount == 0);
+   CHECK(schedule[2].transitionCount == 1);
+   CHECK(schedule[3].transitionCount == 0);
+   // Both pass transitions and the one into the output state.
+   CHECK(f.graph.GetStats().transitions == 3);
+
+   const std::vector<NullCommand> commands = f.Execute();
+   REQUIRE(commands.size() == 3);
+   // Depth targets start out in DepthWrite.
+   CHECK(IsTransition(
+       commands[0], *f.a, ResourceState::DepthWrite, ResourceState::RenderTarget));
+   CHECK(IsTransition(
+       commands[1], *f.a, ResourceState::RenderTarget, ResourceState::ShaderResource));
+   CHECK(IsTransition(
+       commands[2], *f.a, ResourceState::ShaderResource, ResourceState::CopySource));
+}
+
+TEST_CASE("RenderGraph notes cross queue waits and records every pass on one list",
+          "[RenderGraph]") {
+   Fixture f;
+   const auto a = f.graph.ImportTexture(*f.a);
+   const auto b = f.graph.ImportTexture(*f.b);
+   f.AddPass("Upload", PassQueue::Copy).Write(b, ResourceState::CopyDest);
+   f.AddPass("Simulate", PassQueue::Compute)
+       .Read(b, ResourceState::ShaderResource)
+       .Write(a, ResourceState::UnorderedAccess);
+   f.AddPass("Draw")
+       .Read(a, ResourceState::ShaderResource)
+       .Read(b, ResourceState::ShaderResource)
+       .HasSideEffects();
+   f.graph.SetOutput(a, ResourceState::ShaderResource);
+   f.AddPass("Present").HasSideEffects();
+   f.graph.Compile();
+
+   const auto& schedule = f.graph.GetSchedule();
+   REQUIRE(schedule.size() == 4);
+   CHECK(schedule[0].queueWaits == 0);
+   CHECK(schedule[1].queue == PassQueue::Compute);
+   CHECK(schedule[1].queueWaits == 1u << static_cast<uint32_t>(PassQueue::Copy));
+   CHECK(schedule[2].queueWaits == (1u << static_cast<uint32_t>(PassQueue::Copy) |
+                                    1u << static_cast<uint32_t>(PassQueue::Compute)));
+   CHECK(schedule[3].queueWaits == 0);
+
+   f.Execute();
+   CHECK(f.executed ==
+         std::vector<std::string_view>{"Upload", "Simulate", "Draw", "Present"});
+}
+
+TEST_CASE("RenderGraph rejects transient outputs that nothing writes", "[RenderGraph]") {
+   Fixture f;
+   const auto a = f.graph.ImportTexture(*f.a);
+   const auto scratch = f.graph.CreateTexture(transientDesc);
+   f.AddPass("Draw").Write(a, ResourceState::RenderTarget);
+   f.graph.SetOutput(scratch, ResourceState::ShaderResource);
+   CHECK_THROWS_AS(f.graph.Compile(), std::logic_error);
+   CHECK_THROWS_AS(f.Execute(), std::logic_error);
+
+   // An imported texture is only transitioned, which needs no writer.
+   f.graph.Reset();
+   const auto b = f.graph.ImportTexture(*f.b);
+   f.graph.SetOutput(b, ResourceState::Present);
+   f.graph.Compile();
+   CHECK(f.graph.GetSchedule().empty());
+   const std::vector<NullCommand> commands = f.Execute();
+   REQUIRE(commands.size() == 1);
+   CHECK(IsTransition(commands[0], *f.b, ResourceState::DepthWrite, ResourceState::Present));
+}
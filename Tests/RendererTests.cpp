@@ -0,0 +1,51 @@
+//
+// RendererTests.cpp - The renderer driven headless on the null backend
+//
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+
+#include "Graphics/NullDevice.h"
+#include "Graphics/Renderer.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   // Ticks until count frames have been presented, or gives up after a few seconds.
+   uint64_t TickUntilPresented(Renderer& renderer, NullDevice& device, uint64_t count) {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (device.GetCounters().presents < count && std::chrono::steady_clock::now() < deadline) {
+         renderer.Tick();
+      }
+      return device.GetCounters().presents;
+   }
+}
+
+TEST_CASE("Renderer presents frames on null device", "[Renderer]") {
+   NullDevice device({.refreshInterval = std::chrono::milliseconds(1)});
+   {
+      Renderer renderer(device);
+      renderer.Initialize(nullptr, 320, 180);
+      CHECK(TickUntilPresented(renderer, device, 10) >= 10u);
+      renderer.WaitForGpu();
+   }
+   const NullDeviceCounters counters = device.GetCounters();
+   CHECK(counters.executes >= 10u);
+   CHECK(counters.signals >= counters.presents);
+}
+
+TEST_CASE("Renderer keeps presenting across resize and frame count changes", "[Renderer]") {
+   NullDevice device({.refreshInterval = std::chrono::milliseconds(1)});
+   Renderer renderer(device);
+   renderer.Initialize(nullptr, 320, 180);
+   CHECK(TickUntilPresented(renderer, device, 5) >= 5u);
+
+   renderer.OnWindowSizeChanged(640, 360);
+   renderer.SetFramesInFlight(Renderer::MaxFramesInFlight + 1);
+   CHECK(renderer.GetFramesInFlight() == Renderer::MaxFramesInFlight);
+   CHECK(TickUntilPresented(renderer, device, 10) >= 10u);
+   CHECK(device.GetCounters().resizes == 1u);
+   renderer.WaitForGpu();
+}
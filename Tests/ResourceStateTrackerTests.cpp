@@ -0,0 +1,191 @@
+//
+// ResourceStateTrackerTests.cpp - Barrier elision, merging and resolution across command lists
+//
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "Graphics/CommandRecorder.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/ResourceStateTracker.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   std::vector<NullCommand> Transitions(const CommandList& commandList) {
+      std::vector<NullCommand> transitions;
+      for (const NullCommand& command : static_cast<const NullCommandList&>(commandList)
+                                            .GetCommands()) {
+         if (command.op == NullCommand::Op::Transition) {
+            transitions.push_back(command);
+         }
+      }
+      return transitions;
+   }
+
+   bool IsTransition(const NullCommand& command,
+                     const Texture& texture,
+                     ResourceState before,
+                     ResourceState after) {
+      return command.op == NullCommand::Op::Transition && command.target == &texture &&
+             command.before == before && command.after == after;
+   }
+
+   // Captures the lists of every Execute before passing them on, so tests can look inside.
+   class RecordingQueue : public Queue {
+    public:
+      explicit RecordingQueue(Queue& queue) : queue(queue) {
+      }
+
+      void Execute(std::span<CommandList* const> commandLists) override {
+         executed.assign(commandLists.begin(), commandLists.end());
+         executes++;
+         queue.Execute(commandLists);
+      }
+
+      void Signal(uint64_t value) override {
+         queue.Signal(value);
+      }
+
+      [[nodiscard]] uint64_t GetCompletedValue() const override {
+         return queue.GetCompletedValue();
+      }
+
+      bool Wait(uint64_t value, std::chrono::milliseconds timeout) override {
+         return queue.Wait(value, timeout);
+      }
+
+      Queue& queue;
+      std::vector<CommandList*> executed;
+      uint32_t executes{0};
+   };
+
+   struct Fixture {
+      NullDevice device;
+      RecordingQueue queue{device.GetQueue()};
+      CommandRecorder recorder{device};
+      std::unique_ptr<Texture> a = device.CreateDepthTarget(4, 4);
+      std::unique_ptr<Texture> b = device.CreateDepthTarget(4, 4);
+      uint64_t fenceValue{0};
+
+      void Submit() {
+         recorder.Submit(queue, ++fenceValue);
+         queue.Signal(fenceValue);
+      }
+   };
+}
+
+TEST_CASE("ResourceStateTracker drops transitions to the current state", "[ResourceStateTracker]") {
+   Fixture f;
+   f.recorder.BeginFrame(1);
+   CommandList& list = f.recorder.Open(0);
+   ResourceStateTracker& states = f.recorder.GetStateTracker(0);
+
+   // Depth targets start out in DepthWrite.
+   states.Require(*f.a, ResourceState::DepthWrite);
+   states.Flush(list);
+   CHECK(Transitions(list).empty());
+
+   states.Require(*f.a, ResourceState::ShaderResource);
+   states.Flush(list);
+   states.Require(*f.a, ResourceState::ShaderResource);
+   states.Flush(list);
+   REQUIRE(Transitions(list).size() == 1);
+   f.Submit();
+}
+
+TEST_CASE("ResourceStateTracker merges changes between flushes", "[ResourceStateTracker]") {
+   Fixture f;
+   f.recorder.BeginFrame(1);
+   CommandList& list = f.recorder.Open(0);
+   ResourceStateTracker& states = f.recorder.GetStateTracker(0);
+
+   states.Require(*f.a, ResourceState::ShaderResource);
+   states.Require(*f.a, ResourceState::CopyDest);
+   states.Require(*f.a, ResourceState::CopySource);
+   // Ends where it started, so nothing is recorded for b.
+   states.Require(*f.b, ResourceState::ShaderResource);
+   states.Require(*f.b, ResourceState::DepthWrite);
+   states.Flush(list);
+
+   const auto transitions = Transitions(list);
+   REQUIRE(transitions.size() == 1);
+   CHECK(IsTransition(
+       transitions[0], *f.a, ResourceState::DepthWrite, ResourceState::CopySource));
+   CHECK(static_cast<NullCommandList&>(list).GetBarrierBatchCount() == 1);
+   f.Submit();
+}
+
+TEST_CASE("ResourceStateTracker resolves entry states across lists", "[ResourceStateTracker]") {
+   Fixture f;
+   f.recorder.BeginFrame(3);
+   // Recorded out of order, as parallel workers might.
+   CommandList& list2 = f.recorder.Open(2);
+   f.recorder.GetStateTracker(2).Require(*f.a, ResourceState::CopySource);
+   f.recorder.GetStateTracker(2).Flush(list2);
+   CommandList& list1 = f.recorder.Open(1);
+   f.recorder.GetStateTracker(1).Require(*f.a, ResourceState::ShaderResource);
+   f.recorder.GetStateTracker(1).Require(*f.b, ResourceState::ShaderResource);
+   f.recorder.GetStateTracker(1).Flush(list1);
+   CommandList& list0 = f.recorder.Open(0);
+   f.recorder.GetStateTracker(0).Require(*f.a, ResourceState::RenderTarget);
+   f.recorder.GetStateTracker(0).Flush(list0);
+   f.Submit();
+
+   REQUIRE(f.queue.executed.size() == 3);
+   CHECK(f.queue.executed[0] == &list0);
+
+   // List 0 leads, so its own entry transition was recorded in place at its head. What lists 1
+   // and 2 need on entry goes at the end of the list before each.
+   const auto first = Transitions(list0);
+   REQUIRE(first.size() == 3);
+   CHECK(IsTransition(first[0], *f.a, ResourceState::DepthWrite, ResourceState::RenderTarget));
+   CHECK(IsTransition(
+       first[1], *f.a, ResourceState::RenderTarget, ResourceState::ShaderResource));
+   CHECK(IsTransition(first[2], *f.b, ResourceState::DepthWrite, ResourceState::ShaderResource));
+
+   const auto second = Transitions(list1);
+   REQUIRE(second.size() == 1);
+   CHECK(IsTransition(
+       second[0], *f.a, ResourceState::ShaderResource, ResourceState::CopySource));
+
+   CHECK(Transitions(list2).empty());
+   CHECK(f.a->GetCommittedState() == ResourceState::CopySource);
+   CHECK(f.b->GetCommittedState() == ResourceState::ShaderResource);
+}
+
+TEST_CASE("ResourceStateTracker needs no prologue while list 0 is used", "[ResourceStateTracker]") {
+   Fixture f;
+   for (int frame = 0; frame < 3; frame++) {
+      f.recorder.BeginFrame(1);
+      CommandList& list = f.recorder.Open(0);
+      ResourceStateTracker& states = f.recorder.GetStateTracker(0);
+      states.Require(*f.a, frame % 2 == 0 ? ResourceState::ShaderResource
+                                          : ResourceState::DepthWrite);
+      states.Flush(list);
+      f.Submit();
+      CHECK(f.queue.executed.size() == 1);
+      CHECK(Transitions(list).size() == 1);
+   }
+   CHECK(f.a->GetCommittedState() == ResourceState::ShaderResource);
+}
+
+TEST_CASE("ResourceStateTracker uses a prologue when list 0 is unused", "[ResourceStateTracker]") {
+   Fixture f;
+   f.recorder.BeginFrame(2);
+   CommandList& list = f.recorder.Open(1);
+   f.recorder.GetStateTracker(1).Require(*f.a, ResourceState::ShaderResource);
+   f.recorder.GetStateTracker(1).Flush(list);
+   f.Submit();
+
+   REQUIRE(f.queue.executed.size() == 2);
+   CHECK(f.queue.executed[1] == &list);
+   const auto prologue = Transitions(*f.queue.executed[0]);
+   REQUIRE(prologue.size() == 1);
+   CHECK(IsTransition(
+       prologue[0], *f.a, ResourceState::DepthWrite, ResourceState::ShaderResource));
+   CHECK(Transitions(list).empty());
+}
@@ -0,0 +1,150 @@
+//
+// StepTimerTests.cpp - StepTimer driven by synthetic time from a ManualClock
+//
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <exception>
+
+#include "StepTimer.h"
+
+using namespace TX;
+
+namespace {
+
+   using ManualTimer = BasicStepTimer<ManualClock>;
+
+   // ManualClock's default frequency matches the timer's ticks, so counts and ticks are equal.
+   constexpr uint64_t second = ManualTimer::TicksPerSecond;
+   constexpr uint64_t maxDelta = second / 10;
+
+   // Ticks once and returns how many Updates ran.
+   uint32_t Tick(ManualTimer& timer) {
+      uint32_t updates = 0;
+      timer.Tick([&] { updates++; });
+      return updates;
+   }
+}
+
+TEST_CASE("StepTimer measures variable steps in ManualClock time", "[StepTimer]") {
+   ManualTimer timer;
+   timer.GetClock().Advance(second / 50);
+   CHECK(Tick(timer) == 1);
+   CHECK(timer.GetElapsedTicks() == second / 50);
+
+   timer.GetClock().Advance(second / 100);
+   CHECK(Tick(timer) == 1);
+   CHECK(timer.GetElapsedTicks() == second / 100);
+   CHECK(timer.GetTotalTicks() == second / 50 + second / 100);
+   CHECK(timer.GetFrameCount() == 2);
+   CHECK(timer.GetDroppedTicks() == 0);
+   CHECK(timer.GetInterpolationAlpha() == 1.0);
+}
+
+TEST_CASE("StepTimer converts clock counts into ticks", "[StepTimer]") {
+   ManualTimer timer(ManualClock(1'000'000'000));
+   timer.GetClock().AdvanceSeconds(0.016);
+   Tick(timer);
+   CHECK(timer.GetElapsedTicks() == ManualTimer::SecondsToTicks(0.016));
+   CHECK(timer.GetElapsedSeconds() == Approx(0.016));
+
+   CHECK_THROWS_AS(ManualTimer(ManualClock(0)), std::exception);
+}
+
+TEST_CASE("StepTimer clamps long pauses and counts what it dropped", "[StepTimer]") {
+   ManualTimer timer;
+   timer.GetClock().Advance(2 * second);
+   Tick(timer);
+   CHECK(timer.GetElapsedTicks() == maxDelta);
+   CHECK(timer.GetDroppedTicks() == 2 * second - maxDelta);
+
+   // ResetElapsedTime forgets time that passed before it.
+   timer.GetClock().Advance(second);
+   timer.ResetElapsedTime();
+   Tick(timer);
+   CHECK(timer.GetElapsedTicks() == 0);
+   CHECK(timer.GetDroppedTicks() == 2 * second - maxDelta);
+}
+
+TEST_CASE("StepTimer frame rate is counted per clock second", "[StepTimer]") {
+   ManualTimer timer;
+   for (int frame = 0; frame < 30; frame++) {
+      // Rounded up so the thirtieth frame completes the second.
+      timer.GetClock().Advance(second / 30 + 1);
+      Tick(timer);
+   }
+   CHECK(timer.GetFramesPerSecond() == 30);
+}
+
+TEST_CASE("StepTimer runs whole fixed steps and keeps the remainder", "[StepTimer]") {
+   ManualTimer timer;
+   timer.SetFixedTimeStep(true);
+   const uint64_t step = timer.GetTargetElapsedTicks();
+   REQUIRE(step == second / 60);
+
+   timer.GetClock().Advance(3 * step + step / 4);
+   CHECK(Tick(timer) == 3);
+   CHECK(timer.GetElapsedTicks() == step);
+   CHECK(timer.GetTotalTicks() == 3 * step);
+   CHECK(timer.GetLeftOverTicks() == step / 4);
+   CHECK(timer.GetInterpolationAlpha() == Approx(0.25).epsilon(1e-4));
+
+   // The remainder counts towards the next step.
+   timer.GetClock().Advance(step - step / 4 - step / 10);
+   CHECK(Tick(timer) == 0);
+   CHECK(timer.GetInterpolationAlpha() == Approx(0.9).epsilon(1e-4));
+   timer.GetClock().Advance(step / 10 + 1);
+   CHECK(Tick(timer) == 1);
+   CHECK(timer.GetInterpolationAlpha() < 0.001);
+   CHECK(timer.GetDroppedTicks() == 0);
+}
+
+TEST_CASE("StepTimer snaps deltas within a quarter millisecond of the step", "[StepTimer]") {
+   ManualTimer timer;
+   timer.SetFixedTimeStep(true);
+   const uint64_t step = timer.GetTargetElapsedTicks();
+   const uint64_t quarterMillisecond = second / 4000;
+
+   // A 59.94 Hz display runs slightly slow of a 60 Hz step. The error is dropped every frame
+   // instead of adding up to a skipped Update.
+   for (int frame = 0; frame < 1000; frame++) {
+      timer.GetClock().Advance(step + quarterMillisecond - 1);
+      CHECK(Tick(timer) == 1);
+   }
+   CHECK(timer.GetLeftOverTicks() == 0);
+
+   timer.GetClock().Advance(step - (quarterMillisecond - 1));
+   CHECK(Tick(timer) == 1);
+   CHECK(timer.GetLeftOverTicks() == 0);
+
+   // Just outside the window the difference is kept.
+   timer.GetClock().Advance(step + quarterMillisecond);
+   CHECK(Tick(timer) == 1);
+   CHECK(timer.GetLeftOverTicks() == quarterMillisecond);
+}
+
+TEST_CASE("StepTimer bounds catch-up Updates and counts the dropped steps", "[StepTimer]") {
+   ManualTimer timer;
+   timer.SetFixedTimeStep(true);
+   timer.SetMaxUpdatesPerTick(2);
+   const uint64_t step = timer.GetTargetElapsedTicks();
+
+   timer.GetClock().Advance(5 * step + 1234);
+   CHECK(Tick(timer) == 2);
+   CHECK(timer.GetTotalTicks() == 2 * step);
+   CHECK(timer.GetDroppedTicks() == 3 * step);
+   // The fraction survives, so interpolation does not jump.
+   CHECK(timer.GetLeftOverTicks() == 1234);
+
+   timer.GetClock().Advance(step);
+   CHECK(Tick(timer) == 1);
+   CHECK(timer.GetLeftOverTicks() == 1234);
+
+   // Unlimited again, a pause runs as many steps as fit in the clamped delta.
+   timer.SetMaxUpdatesPerTick(0);
+   timer.GetClock().Advance(2 * second);
+   CHECK(Tick(timer) == (1234 + maxDelta) / step);
+   CHECK(timer.GetLeftOverTicks() == (1234 + maxDelta) % step);
+   CHECK(timer.GetDroppedTicks() == 3 * step + 2 * second - maxDelta);
+}
@@ -0,0 +1,155 @@
+//
+// TimelineTests.cpp - Waiting, timeouts and completion callbacks against a simulated queue
+//
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Graphics/NullDevice.h"
+#include "Graphics/Timeline.h"
+
+using namespace TX::Graphics;
+using namespace std::chrono_literals;
+
+namespace {
+
+   // Each command keeps the simulated GPU busy this long.
+   constexpr auto commandCost = 20ms;
+
+   struct Fixture {
+      NullDevice device{{.commandCost = commandCost}};
+      Timeline timeline{device.GetQueue()};
+      std::unique_ptr<CommandAllocator> allocator = device.CreateCommandAllocator();
+      std::unique_ptr<CommandList> list = device.CreateCommandList();
+      std::unique_ptr<Texture> depth = device.CreateDepthTarget(4, 4);
+
+      // Submits commands worth of GPU work and signals the value that follows it.
+      uint64_t Submit(uint32_t commands) {
+         list->Reset(*allocator);
+         for (uint32_t n = 0; n < commands; n++) {
+            list->ClearDepth(*depth, 1.0f);
+         }
+         list->Close();
+         CommandList* lists[] = {list.get()};
+         device.GetQueue().Execute(lists);
+         return timeline.Signal();
+      }
+   };
+}
+
+TEST_CASE("Timeline reports values as the queue completes them", "[Timeline]") {
+   Fixture f;
+   CHECK(f.timeline.GetNextValue() == 1);
+   const uint64_t first = f.Submit(5);
+   const uint64_t second = f.Submit(0);
+   CHECK((first == 1 && second == 2));
+   CHECK(f.timeline.GetIssuedValue() == 2);
+   CHECK(f.timeline.GetNextValue() == 3);
+   CHECK_FALSE(f.timeline.IsComplete(first));
+
+   f.timeline.Wait(second);
+   CHECK(f.timeline.IsComplete(first));
+   CHECK(f.timeline.GetCompletedValue() >= second);
+   CHECK_THROWS_AS(f.timeline.Wait(second + 1), std::logic_error);
+}
+
+TEST_CASE("Timeline WaitFor gives up after its timeout", "[Timeline]") {
+   Fixture f;
+   const uint64_t value = f.Submit(10);
+   const auto start = std::chrono::steady_clock::now();
+   CHECK_FALSE(f.timeline.WaitFor(value, 5ms));
+   CHECK(std::chrono::steady_clock::now() - start < 10 * commandCost);
+   CHECK_FALSE(f.timeline.IsComplete(value));
+
+   CHECK(f.timeline.WaitFor(value, 10s));
+   CHECK(f.timeline.IsComplete(value));
+   // Already complete, so no timeout is too short.
+   CHECK(f.timeline.WaitFor(value, 0ns));
+   CHECK_THROWS_AS(f.timeline.WaitFor(value + 1, 1ms), std::logic_error);
+}
+
+TEST_CASE("Timeline WaitForIdle waits for everything submitted", "[Timeline]") {
+   Fixture f;
+   f.Submit(3);
+   f.Submit(3);
+   f.timeline.WaitForIdle();
+   CHECK(f.timeline.GetIssuedValue() == 3);
+   CHECK(f.timeline.IsComplete(3));
+   CHECK(f.device.GetQueue().GetCompletedValue() == 3);
+}
+
+TEST_CASE("Timeline releases every waiter once its value is reached", "[Timeline]") {
+   Fixture f;
+   const uint64_t early = f.Submit(2);
+   const uint64_t late = f.Submit(4);
+
+   std::mutex mutex;
+   std::vector<uint64_t> released;
+   std::vector<std::thread> waiters;
+   for (int n = 0; n < 6; n++) {
+      const uint64_t value = n % 2 == 0 ? early : late;
+      waiters.emplace_back([&, value] {
+         f.timeline.Wait(value);
+         CHECK(f.timeline.IsComplete(value));
+         const std::lock_guard lock(mutex);
+         released.push_back(value);
+      });
+   }
+   for (auto& waiter : waiters) {
+      waiter.join();
+   }
+   CHECK(released.size() == 6);
+   CHECK(std::count(released.begin(), released.end(), early) == 3);
+   CHECK(std::count(released.begin(), released.end(), late) == 3);
+}
+
+TEST_CASE("Timeline runs callbacks in value order, then registration order", "[Timeline]") {
+   Fixture f;
+   const uint64_t first = f.Submit(3);
+   const uint64_t second = f.Submit(3);
+
+   std::mutex mutex;
+   std::vector<int> order;
+   const auto record = [&](int id) {
+      return [&, id] {
+         const std::lock_guard lock(mutex);
+         order.push_back(id);
+      };
+   };
+   f.timeline.OnComplete(second, record(3));
+   f.timeline.OnComplete(first, record(1));
+   f.timeline.OnComplete(second, record(4));
+   f.timeline.OnComplete(first, record(2));
+
+   std::promise<void> done;
+   f.timeline.OnComplete(second, [&] { done.set_value(); });
+   REQUIRE(done.get_future().wait_for(10s) == std::future_status::ready);
+   const std::lock_guard lock(mutex);
+   CHECK(order == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("Timeline runs callbacks for values already completed", "[Timeline]") {
+   Fixture f;
+   const uint64_t value = f.Submit(1);
+   f.timeline.Wait(value);
+
+   std::promise<std::thread::id> ran;
+   f.timeline.OnComplete(value, [&] { ran.set_value(std::this_thread::get_id()); });
+   auto future = ran.get_future();
+   REQUIRE(future.wait_for(10s) == std::future_status::ready);
+   // On the dispatcher, not on the thread that registered it.
+   CHECK(future.get() != std::this_thread::get_id());
+
+   // Value 0 is complete before anything is submitted.
+   std::promise<void> zero;
+   f.timeline.OnComplete(0, [&] { zero.set_value(); });
+   CHECK(zero.get_future().wait_for(10s) == std::future_status::ready);
+}
@@ -0,0 +1,91 @@
+//
+// UploadRingTests.cpp - Per frame partitions, contexts and the end of a partition
+//
+
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+
+#include "Graphics/NullDevice.h"
+#include "Graphics/Timeline.h"
+#include "Graphics/UploadRing.h"
+
+using namespace TX::Graphics;
+
+namespace {
+
+   constexpr uint64_t partitionSize = 64 * 1024;
+   constexpr uint64_t chunkSize = 16 * 1024;
+
+   struct Fixture {
+      NullDevice device;
+      Timeline timeline{device.GetQueue()};
+      UploadRing ring{device, timeline, partitionSize, 2, chunkSize};
+
+      void EndFrame() {
+         ring.EndFrame(timeline.Signal());
+      }
+   };
+}
+
+TEST_CASE("UploadRing hands out aligned memory inside the frame's partition", "[UploadRing]") {
+   Fixture f;
+   f.ring.BeginFrame();
+   UploadRing::Context context(f.ring);
+   const auto first = context.Allocate(3, 1);
+   const auto second = context.Allocate(64, UploadRing::ConstantBufferAlignment);
+   const auto third = f.ring.Allocate(100, UploadRing::TextureDataAlignment);
+
+   CHECK(second.gpuAddress % UploadRing::ConstantBufferAlignment == 0);
+   CHECK(third.gpuAddress % UploadRing::TextureDataAlignment == 0);
+   CHECK(second.data - first.data == static_cast<ptrdiff_t>(second.gpuAddress - first.gpuAddress));
+   // The context claimed a whole chunk, and the ring allocation went after it.
+   CHECK(third.gpuAddress >= first.gpuAddress + chunkSize);
+   CHECK(f.ring.GetFrameUsage() == chunkSize + 100);
+   CHECK_THROWS_AS(context.Allocate(1, 3), std::invalid_argument);
+   f.EndFrame();
+}
+
+TEST_CASE("UploadRing contexts use the tail of a partition", "[UploadRing]") {
+   Fixture f;
+   f.ring.BeginFrame();
+   // Leaves less than a chunk, but room for several small allocations.
+   f.ring.Allocate(partitionSize - chunkSize / 2, 1);
+
+   UploadRing::Context context(f.ring);
+   uint64_t allocated = 0;
+   for (int i = 0; i < 16; i++) {
+      const auto allocation = context.Allocate(256, UploadRing::ConstantBufferAlignment);
+      CHECK(allocation.gpuAddress + allocation.size <=
+            NullUploadBuffer::GpuAddress + partitionSize);
+      allocated += allocation.size;
+   }
+   CHECK(allocated == 16 * 256);
+   CHECK(f.ring.GetFrameUsage() == partitionSize);
+
+   // The tail is all gone now.
+   for (int i = 0; i < 16; i++) {
+      context.Allocate(256, UploadRing::ConstantBufferAlignment);
+   }
+   CHECK_THROWS_AS(context.Allocate(256, UploadRing::ConstantBufferAlignment), std::length_error);
+   f.EndFrame();
+}
+
+TEST_CASE("UploadRing contexts move to the next partition each frame", "[UploadRing]") {
+   Fixture f;
+   UploadRing::Context context(f.ring);
+   uint64_t previous = 0;
+   for (int frame = 0; frame < 4; frame++) {
+      f.ring.BeginFrame();
+      const auto allocation = context.Allocate(16, 16);
+      const uint64_t partition =
+          (allocation.gpuAddress - NullUploadBuffer::GpuAddress) / partitionSize;
+      CHECK(partition == static_cast<uint64_t>(frame % 2));
+      if (frame > 0) {
+         CHECK(allocation.gpuAddress != previous);
+      }
+      previous = allocation.gpuAddress;
+      f.EndFrame();
+   }
+   f.timeline.WaitForIdle();
+}
@@ -0,0 +1,249 @@
+//
+// TritonLogDecode - Turns a TritonX binary log (see System/BinaryLog.h) back into text
+//
+// Usage: TritonLogDecode <file.blog> [output.txt]
+//
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "System/BinaryLogFormat.h"
+
+using namespace Log::Binary;
+
+namespace {
+   struct Descriptor {
+      uint8_t level;
+      uint32_t line;
+      std::vector<ArgType> argTypes;
+      std::string file;
+      std::string format;
+   };
+
+   struct Message {
+      EntryHeader header;
+      const char* payload;
+      size_t payloadSize;
+   };
+
+   const char* LevelName(uint8_t level) {
+      static constexpr const char* names[] = {"Trace ", "Debug ", "Info  ", "Warn  ", "Error "};
+      return level < std::size(names) ? names[level] : "????? ";
+   }
+
+   // Appends the next argument as text and advances cursor. Returns false on truncated input.
+   bool AppendArg(std::string& out, ArgType type, const char*& cursor, const char* end) {
+      if (type == ArgType::String) {
+         uint32_t length = 0;
+         if (end - cursor < static_cast<ptrdiff_t>(sizeof(length))) {
+            return false;
+         }
+         std::memcpy(&length, cursor, sizeof(length));
+         cursor += sizeof(length);
+         if (end - cursor < static_cast<ptrdiff_t>(length)) {
+            return false;
+         }
+         out.append(cursor, length);
+         cursor += length;
+         return true;
+      }
+
+      if (end - cursor < static_cast<ptrdiff_t>(ScalarSize)) {
+         return false;
+      }
+      uint64_t bits = 0;
+      std::memcpy(&bits, cursor, sizeof(bits));
+      cursor += ScalarSize;
+
+      char text[64] = {};
+      switch (type) {
+         case ArgType::Bool:
+            std::snprintf(text, sizeof(text), "%s", bits ? "true" : "false");
+            break;
+         case ArgType::Int64: {
+            int64_t value = 0;
+            std::memcpy(&value, &bits, sizeof(value));
+            std::snprintf(text, sizeof(text), "%" PRId64, value);
+            break;
+         }
+         case ArgType::UInt64:
+            std::snprintf(text, sizeof(text), "%" PRIu64, bits);
+            break;
+         case ArgType::Double: {
+            double value = 0;
+            std::memcpy(&value, &bits, sizeof(value));
+            std::snprintf(text, sizeof(text), "%g", value);
+            break;
+         }
+         case ArgType::Pointer:
+            std::snprintf(text, sizeof(text), "0x%016" PRIx64, bits);
+            break;
+         default:
+            std::snprintf(text, sizeof(text), "<?>");
+            break;
+      }
+      out.append(text);
+      return true;
+   }
+
+   // Expands {} placeholders in order; {{ and }} are literal braces.
+   std::string Format(const Descriptor& descriptor, const char* payload, size_t payloadSize) {
+      std::string out;
+      const char* cursor = payload;
+      const char* end = payload + payloadSize;
+      size_t arg = 0;
+      const std::string_view format = descriptor.format;
+
+      for (size_t i = 0; i < format.size(); i++) {
+         if (format.compare(i, 2, "{{") == 0 || format.compare(i, 2, "}}") == 0) {
+            out.push_back(format[i]);
+            i++;
+         } else if (format.compare(i, 2, "{}") == 0) {
+            if (arg >= descriptor.argTypes.size() ||
+                !AppendArg(out, descriptor.argTypes[arg++], cursor, end)) {
+               out.append("<missing>");
+            }
+            i++;
+         } else {
+            out.push_back(format[i]);
+         }
+      }
+
+      // Arguments without a placeholder are still worth seeing.
+      while (arg < descriptor.argTypes.size()) {
+         out.append(" | ");
+         if (!AppendArg(out, descriptor.argTypes[arg++], cursor, end)) {
+            out.append("<missing>");
+            break;
+         }
+      }
+      return out;
+   }
+}
+
+int main(int argc, char** argv) {
+   if (argc < 2) {
+      std::fprintf(stderr, "Usage: %s <file.blog> [output.txt]\n", argv[0]);
+      return 1;
+   }
+
+   std::ifstream input(argv[1], std::ios::binary);
+   if (!input) {
+      std::fprintf(stderr, "Cannot open %s\n", argv[1]);
+      return 1;
+   }
+   const std::vector<char> data{std::istreambuf_iterator<char>(input),
+                                std::istreambuf_iterator<char>()};
+
+   FileHeader fileHeader{};
+   if (data.size() < sizeof(fileHeader)) {
+      std::fprintf(stderr, "%s is too small to be a binary log\n", argv[1]);
+      return 1;
+   }
+   std::memcpy(&fileHeader, data.data(), sizeof(fileHeader));
+   if (std::memcmp(fileHeader.magic, Magic, sizeof(Magic)) != 0 ||
+       fileHeader.version != Version || fileHeader.timestampFrequency == 0) {
+      std::fprintf(stderr, "%s is not a version %u binary log\n", argv[1], Version);
+      return 1;
+   }
+
+   FILE* output = stdout;
+   if (argc >= 3) {
+#if defined(_MSC_VER)
+      if (fopen_s(&output, argv[2], "w") != 0) {
+         output = nullptr;
+      }
+#else
+      output = std::fopen(argv[2], "w");
+#endif
+      if (!output) {
+         std::fprintf(stderr, "Cannot write %s\n", argv[2]);
+         return 1;
+      }
+   }
+
+   // Descriptors can land after the first message that uses them, so collect everything before
+   // formatting anything.
+   std::unordered_map<uint32_t, Descriptor> descriptors;
+   std::vector<Message> messages;
+
+   size_t offset = fileHeader.headerSize;
+   while (offset + sizeof(EntryHeader) <= data.size()) {
+      EntryHeader header{};
+      std::memcpy(&header, data.data() + offset, sizeof(header));
+      if (header.size < sizeof(EntryHeader) || offset + header.size > data.size()) {
+         break;
+      }
+
+      const char* payload = data.data() + offset + sizeof(EntryHeader);
+      const size_t payloadSize = header.size - sizeof(EntryHeader);
+
+      if (header.kind == EntryKind::Descriptor && payloadSize >= sizeof(DescriptorPayload)) {
+         DescriptorPayload info{};
+         std::memcpy(&info, payload, sizeof(info));
+         const char* cursor = payload + sizeof(info);
+         if (sizeof(info) + info.argCount + info.fileLength + info.formatLength <= payloadSize) {
+            Descriptor descriptor{};
+            descriptor.level = info.level;
+            descriptor.line = info.line;
+            for (uint8_t i = 0; i < info.argCount; i++) {
+               descriptor.argTypes.push_back(static_cast<ArgType>(cursor[i]));
+            }
+            cursor += info.argCount;
+            descriptor.file.assign(cursor, info.fileLength);
+            cursor += info.fileLength;
+            descriptor.format.assign(cursor, info.formatLength);
+            descriptors.emplace(header.descriptorId, std::move(descriptor));
+         }
+      } else if (header.kind == EntryKind::Message) {
+         messages.push_back(Message{header, payload, payloadSize});
+      }
+
+      offset += header.size;
+   }
+
+   // Threads claim space in nearly, but not exactly, timestamp order.
+   std::stable_sort(messages.begin(), messages.end(), [](const Message& a, const Message& b) {
+      return a.header.timestamp < b.header.timestamp;
+   });
+
+   size_t unknown = 0;
+   for (const auto& message : messages) {
+      const auto found = descriptors.find(message.header.descriptorId);
+      if (found == descriptors.end()) {
+         unknown++;
+         continue;
+      }
+      const Descriptor& descriptor = found->second;
+
+      const uint64_t timestamp = message.header.timestamp;
+      const uint64_t frequency = fileHeader.timestampFrequency;
+      const uint64_t micros =
+          timestamp / frequency * 1000000 + timestamp % frequency * 1000000 / frequency;
+      std::fprintf(output,
+                   "[%6" PRIu64 ".%06" PRIu64 "] %s[%u] %s (%s:%u)\n",
+                   micros / 1000000,
+                   micros % 1000000,
+                   LevelName(descriptor.level),
+                   message.header.threadId,
+                   Format(descriptor, message.payload, message.payloadSize).c_str(),
+                   descriptor.file.c_str(),
+                   descriptor.line);
+   }
+
+   if (unknown > 0) {
+      std::fprintf(stderr, "Skipped %zu messages with unknown call sites\n", unknown);
+   }
+   if (output != stdout) {
+      std::fclose(output);
+   }
+   return 0;
+}
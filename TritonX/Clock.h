@@ -0,0 +1,115 @@
+//
+// Clock.h - Time sources that can drive a StepTimer
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+
+#if defined(_WIN32)
+#include <profileapi.h>
+#elif defined(__linux__)
+#include <time.h>
+#endif
+
+namespace TX {
+   // A clock policy provides a fixed Frequency() in counts per second and a monotonically
+   // increasing Now() expressed in those counts. StepTimer converts counts into its own
+   // canonical tick format, so a policy is free to pick whatever resolution is native to it.
+
+#if defined(_WIN32)
+   // QueryPerformanceCounter backed clock.
+   class QpcClock {
+    public:
+      QpcClock() noexcept(false) {
+         LARGE_INTEGER frequency;
+         if (!QueryPerformanceFrequency(&frequency)) {
+            throw std::exception();
+         }
+         this->frequency = static_cast<uint64_t>(frequency.QuadPart);
+      }
+
+      uint64_t Frequency() const noexcept {
+         return frequency;
+      }
+
+      uint64_t Now() const {
+         LARGE_INTEGER currentTime;
+         if (!QueryPerformanceCounter(&currentTime)) {
+            throw std::exception();
+         }
+         return static_cast<uint64_t>(currentTime.QuadPart);
+      }
+
+    private:
+      uint64_t frequency;
+   };
+#endif
+
+   // Nanosecond clock for non Win32 hosts. Uses CLOCK_MONOTONIC_RAW where available so NTP slewing
+   // cannot stretch or shrink measured frame times, and std::chrono::steady_clock elsewhere.
+   class MonotonicClock {
+    public:
+      static constexpr uint64_t NanosecondsPerSecond = 1000000000;
+
+      uint64_t Frequency() const noexcept {
+         return NanosecondsPerSecond;
+      }
+
+      uint64_t Now() const {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_RAW)
+         timespec ts{};
+         if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) != 0) {
+            throw std::exception();
+         }
+         return static_cast<uint64_t>(ts.tv_sec) * NanosecondsPerSecond +
+                static_cast<uint64_t>(ts.tv_nsec);
+#else
+         const auto now = std::chrono::steady_clock::now().time_since_epoch();
+         return static_cast<uint64_t>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+      }
+   };
+
+   // Deterministic clock that only moves when told to. Used to drive a StepTimer with synthetic
+   // time for benchmarks and replays.
+   class ManualClock {
+    public:
+      explicit ManualClock(uint64_t frequency = 10000000) noexcept :
+          frequency(frequency), now(0) {
+      }
+
+      uint64_t Frequency() const noexcept {
+         return frequency;
+      }
+
+      uint64_t Now() const noexcept {
+         return now;
+      }
+
+      void Advance(uint64_t counts) noexcept {
+         now += counts;
+      }
+
+      void AdvanceSeconds(double seconds) noexcept {
+         now += static_cast<uint64_t>(seconds * static_cast<double>(frequency));
+      }
+
+      void Set(uint64_t counts) noexcept {
+         now = counts;
+      }
+
+    private:
+      uint64_t frequency;
+      uint64_t now;
+   };
+
+#if defined(_WIN32)
+   using DefaultClock = QpcClock;
+#else
+   using DefaultClock = MonotonicClock;
+#endif
+}
@@ -0,0 +1,241 @@
+//
+// FrameStats.h - Allocation free frame time distribution tracking
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "TripleBuffer.h"
+
+namespace TX {
+   // Fixed size log-linear histogram. Values below 2^SubBucketBits get an exact bucket each, above
+   // that every power of two is split into 2^SubBucketBits linear sub-buckets, giving a worst case
+   // relative error of 1 / 2^SubBucketBits. Values at or above 2^MaxValueBits land in the last
+   // bucket.
+   template <uint32_t SubBucketBits, uint32_t MaxValueBits>
+   class LogLinearHistogram {
+    public:
+      static constexpr uint32_t SubBucketCount = 1u << SubBucketBits;
+      static constexpr uint32_t BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBucketCount;
+
+      static constexpr uint32_t BucketIndex(uint64_t value) noexcept {
+         if (value < SubBucketCount) {
+            return static_cast<uint32_t>(value);
+         }
+         const uint32_t msb = static_cast<uint32_t>(std::bit_width(value)) - 1;
+         if (msb >= MaxValueBits) {
+            return BucketCount - 1;
+         }
+         const uint32_t shift = msb - SubBucketBits;
+         const uint32_t sub = static_cast<uint32_t>(value >> shift) & (SubBucketCount - 1);
+         return (msb - SubBucketBits + 1) * SubBucketCount + sub;
+      }
+
+      // Largest value that maps into the given bucket.
+      static constexpr uint64_t BucketUpperBound(uint32_t index) noexcept {
+         if (index < SubBucketCount) {
+            return index;
+         }
+         const uint32_t magnitude = index / SubBucketCount - 1;
+         const uint64_t sub = index % SubBucketCount;
+         return ((SubBucketCount + sub + 1) << magnitude) - 1;
+      }
+
+      void Record(uint64_t value) noexcept {
+         buckets[BucketIndex(value)]++;
+         count++;
+         const double v = static_cast<double>(value);
+         sum += v;
+         sumOfSquares += v * v;
+         minValue = std::min(minValue, value);
+         maxValue = std::max(maxValue, value);
+      }
+
+      void Merge(const LogLinearHistogram& other) noexcept {
+         for (uint32_t i = 0; i < BucketCount; i++) {
+            buckets[i] += other.buckets[i];
+         }
+         count += other.count;
+         sum += other.sum;
+         sumOfSquares += other.sumOfSquares;
+         minValue = std::min(minValue, other.minValue);
+         maxValue = std::max(maxValue, other.maxValue);
+      }
+
+      void Clear() noexcept {
+         *this = LogLinearHistogram{};
+      }
+
+      uint64_t GetCount() const noexcept {
+         return count;
+      }
+      uint64_t GetMin() const noexcept {
+         return count == 0 ? 0 : minValue;
+      }
+      uint64_t GetMax() const noexcept {
+         return maxValue;
+      }
+      double GetMean() const noexcept {
+         return count == 0 ? 0.0 : sum / static_cast<double>(count);
+      }
+      double GetStdDev() const noexcept {
+         if (count < 2) {
+            return 0.0;
+         }
+         const double mean = GetMean();
+         const double variance = sumOfSquares / static_cast<double>(count) - mean * mean;
+         return variance > 0.0 ? std::sqrt(variance) : 0.0;
+      }
+
+      // Value at the given quantile (0..1), reported as the upper bound of the bucket holding it
+      // and clamped to the observed maximum.
+      uint64_t GetPercentile(double quantile) const noexcept {
+         if (count == 0) {
+            return 0;
+         }
+         const auto rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count)));
+         const uint64_t target = std::clamp<uint64_t>(rank, 1, count);
+         uint64_t seen = 0;
+         for (uint32_t i = 0; i < BucketCount; i++) {
+            seen += buckets[i];
+            if (seen >= target) {
+               return std::min(BucketUpperBound(i), maxValue);
+            }
+         }
+         return maxValue;
+      }
+
+    private:
+      std::array<uint32_t, BucketCount> buckets{};
+      uint64_t count{0};
+      double sum{0.0};
+      double sumOfSquares{0.0};
+      uint64_t minValue{std::numeric_limits<uint64_t>::max()};
+      uint64_t maxValue{0};
+   };
+
+   // Summary of one distribution over the current window.
+   struct Distribution {
+      uint64_t count;
+      uint64_t min;
+      uint64_t max;
+      double mean;
+      double stdDev;
+      uint64_t p50;
+      uint64_t p95;
+      uint64_t p99;
+      uint64_t p999;
+   };
+
+   // Everything a monitoring thread needs to alarm on stutter. Tick deltas are in StepTimer ticks
+   // and are measured before the max delta clamp, so debugger pauses and hitches stay visible.
+   struct FrameTimeSnapshot {
+      uint64_t sequence;
+      uint64_t windowTicks;
+      Distribution tickDelta;
+      Distribution updatesPerTick;
+   };
+
+   // Records per-Tick deltas and update counts into a rolling window made of SubWindowCount
+   // equally sized sub-windows. Each time a sub-window closes, the whole window is summarized and
+   // published for one reader thread through a TripleBuffer. Recording must happen on a single
+   // thread (the one calling StepTimer::Tick).
+   class FrameStats {
+    public:
+      static constexpr uint32_t SubWindowCount = 4;
+
+      // Deltas up to 2^32 ticks (~7 minutes) with 1/16 relative precision.
+      using DeltaHistogram = LogLinearHistogram<4, 32>;
+      using UpdateHistogram = LogLinearHistogram<4, 16>;
+
+      explicit FrameStats(uint64_t windowTicks) noexcept {
+         SetWindowTicks(windowTicks);
+      }
+
+      void SetWindowTicks(uint64_t windowTicks) noexcept {
+         subWindowTicks = std::max<uint64_t>(windowTicks / SubWindowCount, 1);
+      }
+
+      uint64_t GetWindowTicks() const noexcept {
+         return subWindowTicks * SubWindowCount;
+      }
+
+      void Record(uint64_t deltaTicks, uint32_t updates) noexcept {
+         auto& window = windows[current];
+         window.deltas.Record(deltaTicks);
+         window.updates.Record(updates);
+
+         elapsedInSubWindow += deltaTicks;
+         if (elapsedInSubWindow >= subWindowTicks) {
+            elapsedInSubWindow = 0;
+            Publish();
+            current = (current + 1) % SubWindowCount;
+            windows[current].deltas.Clear();
+            windows[current].updates.Clear();
+         }
+      }
+
+      void Reset() noexcept {
+         for (auto& window : windows) {
+            window.deltas.Clear();
+            window.updates.Clear();
+         }
+         elapsedInSubWindow = 0;
+      }
+
+      // Reader side, safe to call from one other thread without locking.
+      const FrameTimeSnapshot& ReadSnapshot() noexcept {
+         return snapshots.Read();
+      }
+
+    private:
+      struct SubWindow {
+         DeltaHistogram deltas;
+         UpdateHistogram updates;
+      };
+
+      template <typename THistogram>
+      static Distribution Summarize(const THistogram& histogram) noexcept {
+         return Distribution{.count = histogram.GetCount(),
+                             .min = histogram.GetMin(),
+                             .max = histogram.GetMax(),
+                             .mean = histogram.GetMean(),
+                             .stdDev = histogram.GetStdDev(),
+                             .p50 = histogram.GetPercentile(0.50),
+                             .p95 = histogram.GetPercentile(0.95),
+                             .p99 = histogram.GetPercentile(0.99),
+                             .p999 = histogram.GetPercentile(0.999)};
+      }
+
+      void Publish() noexcept {
+         merged.deltas.Clear();
+         merged.updates.Clear();
+         for (const auto& window : windows) {
+            merged.deltas.Merge(window.deltas);
+            merged.updates.Merge(window.updates);
+         }
+
+         auto& snapshot = snapshots.Back();
+         snapshot.sequence = ++sequence;
+         snapshot.windowTicks = GetWindowTicks();
+         snapshot.tickDelta = Summarize(merged.deltas);
+         snapshot.updatesPerTick = Summarize(merged.updates);
+         snapshots.Publish();
+      }
+
+      std::array<SubWindow, SubWindowCount> windows{};
+      SubWindow merged{};
+      uint32_t current{0};
+      uint64_t subWindowTicks{1};
+      uint64_t elapsedInSubWindow{0};
+      uint64_t sequence{0};
+
+      TripleBuffer<FrameTimeSnapshot> snapshots;
+   };
+}
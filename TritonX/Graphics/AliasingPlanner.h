@@ -0,0 +1,160 @@
+//
+// AliasingPlanner.h - Packs transient resources whose lifetimes never overlap into shared memory
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace TX::Graphics {
+
+   // A transient resource's memory needs and the range of scheduled passes, inclusive, that use
+   // it.
+   struct AliasingRequest {
+      uint64_t size;
+      uint64_t alignment;
+      uint32_t firstPass;
+      uint32_t lastPass;
+   };
+
+   // Before the pass, memory now belonging to after may still hold a resource that used it
+   // before, named by before, or by NoResource if there was more than one.
+   struct AliasingBarrierPlan {
+      uint32_t pass;
+      uint32_t before;
+      uint32_t after;
+   };
+
+   struct AliasingPlan {
+      static constexpr uint32_t NoResource = UINT32_MAX;
+
+      // Offset of each request within the shared heap, in request order.
+      std::vector<uint64_t> offsets;
+      // Ordered by pass.
+      std::vector<AliasingBarrierPlan> barriers;
+      uint64_t heapSize;
+      // What giving every request its own allocation would have taken.
+      uint64_t unaliasedSize;
+   };
+
+   // Greedy interval colouring. Requests are placed largest first, each at the lowest aligned
+   // offset where it collides with no already placed request that is alive at the same time, so
+   // big resources claim the bottom of the heap and small ones fill the gaps above and between.
+   // Placing is O(n^2 log n) in the worst case. About a hundred transients plan in a tenth of a
+   // millisecond, and planning only runs when a render graph is compiled rather than reused.
+   class AliasingPlanner {
+    public:
+      void Plan(std::span<const AliasingRequest> requests, AliasingPlan& plan) {
+         const auto count = static_cast<uint32_t>(requests.size());
+         plan.offsets.assign(count, 0);
+         plan.barriers.clear();
+         plan.heapSize = 0;
+         plan.unaliasedSize = 0;
+
+         order.resize(count);
+         for (uint32_t i = 0; i < count; i++) {
+            order[i] = i;
+            plan.unaliasedSize += AlignUp(requests[i].size, requests[i].alignment);
+         }
+         std::ranges::sort(order, [&](uint32_t a, uint32_t b) {
+            if (requests[a].size != requests[b].size) {
+               return requests[a].size > requests[b].size;
+            }
+            return requests[a].firstPass < requests[b].firstPass;
+         });
+
+         placed.clear();
+         for (const uint32_t index : order) {
+            const auto& request = requests[index];
+
+            // Memory ranges taken by everything alive at the same time, lowest first.
+            taken.clear();
+            for (const uint32_t other : placed) {
+               if (Overlaps(request, requests[other])) {
+                  const uint64_t otherOffset = plan.offsets[other];
+                  taken.push_back({otherOffset, otherOffset + requests[other].size});
+               }
+            }
+            std::ranges::sort(taken, {}, &Range::begin);
+
+            uint64_t offset = 0;
+            for (const auto& range : taken) {
+               offset = AlignUp(offset, request.alignment);
+               if (offset + request.size <= range.begin) {
+                  break;
+               }
+               offset = std::max(offset, range.end);
+            }
+            offset = AlignUp(offset, request.alignment);
+
+            plan.offsets[index] = offset;
+            plan.heapSize = std::max(plan.heapSize, offset + request.size);
+            placed.push_back(index);
+         }
+
+         PlanBarriers(requests, plan);
+      }
+
+    private:
+      struct Range {
+         uint64_t begin;
+         uint64_t end;
+      };
+
+      std::vector<uint32_t> order;
+      std::vector<uint32_t> placed;
+      std::vector<Range> taken;
+
+      static constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept {
+         return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+      }
+
+      static constexpr bool Overlaps(const AliasingRequest& a, const AliasingRequest& b) noexcept {
+         return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+      }
+
+      // A request needs a barrier if another request shares its memory. It takes the memory
+      // over from whichever of them were used earlier in the frame or, if it is the first user,
+      // from the ones used later in the previous frame. One is named in the barrier; with several,
+      // D3D12 accepts none named.
+      static void PlanBarriers(std::span<const AliasingRequest> requests, AliasingPlan& plan) {
+         const auto count = static_cast<uint32_t>(requests.size());
+         for (uint32_t after = 0; after < count; after++) {
+            const auto& request = requests[after];
+            const uint64_t begin = plan.offsets[after];
+            const uint64_t end = begin + request.size;
+
+            uint32_t earlier = 0;
+            uint32_t earlierResource = AliasingPlan::NoResource;
+            uint32_t later = 0;
+            uint32_t laterResource = AliasingPlan::NoResource;
+            for (uint32_t other = 0; other < count; other++) {
+               const uint64_t otherBegin = plan.offsets[other];
+               const uint64_t otherEnd = otherBegin + requests[other].size;
+               if (other == after || otherEnd <= begin || end <= otherBegin) {
+                  continue;
+               }
+               // Sharing memory means their lifetimes do not overlap.
+               if (requests[other].lastPass < request.firstPass) {
+                  earlier++;
+                  earlierResource = other;
+               } else {
+                  later++;
+                  laterResource = other;
+               }
+            }
+
+            const uint32_t sharers = earlier > 0 ? earlier : later;
+            const uint32_t sharer = earlier > 0 ? earlierResource : laterResource;
+            if (sharers > 0) {
+               const uint32_t before = sharers == 1 ? sharer : AliasingPlan::NoResource;
+               plan.barriers.push_back({request.firstPass, before, after});
+            }
+         }
+         std::ranges::stable_sort(plan.barriers, {}, &AliasingBarrierPlan::pass);
+      }
+   };
+}
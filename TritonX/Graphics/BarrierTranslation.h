@@ -0,0 +1,106 @@
+//
+// BarrierTranslation.h - Maps state transitions onto precise sync, access and layout scopes
+//
+
+#pragma once
+
+#include "Graphics/Device.h"
+
+namespace TX::Graphics {
+
+   // The pipeline work a barrier waits for, or blocks. Mirrors the D3D12_BARRIER_SYNC values the
+   // renderer needs; backends map these onto their native equivalents.
+   enum class BarrierSync {
+      None,
+      All,
+      RenderTarget,
+      DepthStencil,
+      AllShading,
+      Copy,
+   };
+
+   // How that work touches the texture. Mirrors D3D12_BARRIER_ACCESS.
+   enum class BarrierAccess {
+      NoAccess,
+      Common,
+      RenderTarget,
+      DepthStencilWrite,
+      DepthStencilRead,
+      ShaderResource,
+      UnorderedAccess,
+      CopySource,
+      CopyDest,
+   };
+
+   // Mirrors D3D12_BARRIER_LAYOUT.
+   enum class BarrierLayout {
+      Common,
+      Present,
+      RenderTarget,
+      DepthStencilWrite,
+      DepthStencilRead,
+      ShaderResource,
+      UnorderedAccess,
+      CopySource,
+      CopyDest,
+   };
+
+   struct BarrierScope {
+      BarrierSync sync;
+      BarrierAccess access;
+      BarrierLayout layout;
+
+      constexpr bool operator==(const BarrierScope&) const noexcept = default;
+   };
+
+   struct ScopedTextureBarrier {
+      Texture* texture;
+      BarrierScope before;
+      BarrierScope after;
+
+      constexpr bool operator==(const ScopedTextureBarrier&) const noexcept = default;
+   };
+
+   // A legacy transition waits for all prior work and blocks all later work. The scope of a state
+   // names only the stage that actually uses a texture in it, so a barrier waits for just the
+   // pass that produced it and holds back just the pass that consumes it. A back buffer only
+   // enters and leaves Present across ExecuteCommandLists boundaries, which synchronize already,
+   // so Present needs no sync or access. Common can be used by anything and stays conservative.
+   constexpr BarrierScope ToBarrierScope(ResourceState state) noexcept {
+      switch (state) {
+         case ResourceState::Common:
+            return {BarrierSync::All, BarrierAccess::Common, BarrierLayout::Common};
+         case ResourceState::Present:
+            return {BarrierSync::None, BarrierAccess::NoAccess, BarrierLayout::Present};
+         case ResourceState::RenderTarget:
+            return {BarrierSync::RenderTarget,
+                    BarrierAccess::RenderTarget,
+                    BarrierLayout::RenderTarget};
+         case ResourceState::DepthWrite:
+            return {BarrierSync::DepthStencil,
+                    BarrierAccess::DepthStencilWrite,
+                    BarrierLayout::DepthStencilWrite};
+         case ResourceState::DepthRead:
+            return {BarrierSync::DepthStencil,
+                    BarrierAccess::DepthStencilRead,
+                    BarrierLayout::DepthStencilRead};
+         case ResourceState::ShaderResource:
+            return {BarrierSync::AllShading,
+                    BarrierAccess::ShaderResource,
+                    BarrierLayout::ShaderResource};
+         case ResourceState::UnorderedAccess:
+            return {BarrierSync::AllShading,
+                    BarrierAccess::UnorderedAccess,
+                    BarrierLayout::UnorderedAccess};
+         case ResourceState::CopySource:
+            return {BarrierSync::Copy, BarrierAccess::CopySource, BarrierLayout::CopySource};
+         case ResourceState::CopyDest:
+            return {BarrierSync::Copy, BarrierAccess::CopyDest, BarrierLayout::CopyDest};
+      }
+      return {BarrierSync::All, BarrierAccess::Common, BarrierLayout::Common};
+   }
+
+   constexpr ScopedTextureBarrier ToScopedBarrier(const TextureBarrier& barrier) noexcept {
+      return {barrier.texture, ToBarrierScope(barrier.before), ToBarrierScope(barrier.after)};
+   }
+}
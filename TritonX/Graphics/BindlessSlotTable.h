@@ -0,0 +1,137 @@
+//
+// BindlessSlotTable.h - Stable, generation checked indices into a bindless descriptor heap
+//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "Graphics/Timeline.h"
+
+namespace TX::Graphics {
+
+   // Names one slot of a bindless heap. index is what shaders see. generation tells a handle to
+   // a slot that has since been released, and possibly reused, from a live one.
+   struct BindlessHandle {
+      uint32_t index{0};
+      // 0 is never a live generation, so a default constructed handle is invalid.
+      uint32_t generation{0};
+
+      constexpr bool operator==(const BindlessHandle&) const noexcept = default;
+   };
+
+   // Hands out the slots of a fixed size bindless heap. A resource keeps its index for as long
+   // as it lives, so shaders can be given indices once instead of having tables set up per draw.
+   //
+   // Release invalidates the handle straight away but only makes the slot reusable once the
+   // timeline passes its next value, since command lists already submitted may still index it.
+   // Collect returns those slots to the free list and is meant to be called once per frame.
+   // Everything else may be called from any thread.
+   //
+   //    const BindlessHandle albedo = slots.Allocate();
+   //    ... write the descriptor at albedo.index, pass albedo.index to shaders
+   //    slots.Release(albedo);
+   //    ...
+   //    slots.Collect(); // once per frame
+   class BindlessSlotTable {
+    public:
+      BindlessSlotTable(Timeline& timeline, uint32_t capacity) :
+          timeline(timeline), generations(capacity, 1), live(capacity, 0) {
+         freeSlots.reserve(capacity);
+         // Hand out low indices first.
+         for (uint32_t index = capacity; index > 0; index--) {
+            freeSlots.push_back(index - 1);
+         }
+      }
+
+      BindlessSlotTable(const BindlessSlotTable&) = delete;
+      BindlessSlotTable& operator=(const BindlessSlotTable&) = delete;
+
+      // Throws std::length_error if every slot is live or waiting for the GPU.
+      BindlessHandle Allocate() {
+         std::lock_guard lock(mutex);
+         if (freeSlots.empty()) {
+            throw std::length_error("BindlessSlotTable has no free slots");
+         }
+         const uint32_t index = freeSlots.back();
+         freeSlots.pop_back();
+         live[index] = 1;
+         liveCount++;
+         return {index, generations[index]};
+      }
+
+      // Throws std::logic_error if handle is not live.
+      void Release(BindlessHandle handle) {
+         const uint64_t fenceValue = timeline.GetNextValue();
+         std::lock_guard lock(mutex);
+         if (!IsLiveLocked(handle)) {
+            throw std::logic_error("BindlessSlotTable handle released that is not live");
+         }
+         live[handle.index] = 0;
+         liveCount--;
+         generations[handle.index] = NextGeneration(handle.generation);
+         retired.push_back({fenceValue, handle.index});
+      }
+
+      // Makes the slots the GPU has finished with allocatable again. Slots are checked in release
+      // order, so one released with a later value holds back those behind it until it completes.
+      void Collect() {
+         const uint64_t completedValue = timeline.GetCompletedValue();
+         std::lock_guard lock(mutex);
+         while (!retired.empty() && retired.front().fenceValue <= completedValue) {
+            freeSlots.push_back(retired.front().index);
+            retired.pop_front();
+         }
+      }
+
+      // The generation a slot gets when a handle of generation is released. Skips 0 on wrap
+      // around so that it stays invalid.
+      [[nodiscard]] static constexpr uint32_t NextGeneration(uint32_t generation) noexcept {
+         return generation == UINT32_MAX ? 1 : generation + 1;
+      }
+
+      [[nodiscard]] bool IsLive(BindlessHandle handle) const {
+         std::lock_guard lock(mutex);
+         return IsLiveLocked(handle);
+      }
+
+      [[nodiscard]] uint32_t GetCapacity() const noexcept {
+         return static_cast<uint32_t>(generations.size());
+      }
+
+      [[nodiscard]] uint32_t GetLiveCount() const {
+         std::lock_guard lock(mutex);
+         return liveCount;
+      }
+
+      // Released slots still waiting for the GPU.
+      [[nodiscard]] size_t GetRetiredCount() const {
+         std::lock_guard lock(mutex);
+         return retired.size();
+      }
+
+    private:
+      struct Retired {
+         uint64_t fenceValue;
+         uint32_t index;
+      };
+
+      Timeline& timeline;
+
+      mutable std::mutex mutex;
+      std::vector<uint32_t> generations;
+      std::vector<uint8_t> live;
+      std::vector<uint32_t> freeSlots;
+      std::deque<Retired> retired;
+      uint32_t liveCount{0};
+
+      [[nodiscard]] bool IsLiveLocked(BindlessHandle handle) const noexcept {
+         return handle.index < generations.size() && live[handle.index] &&
+                generations[handle.index] == handle.generation;
+      }
+   };
+}
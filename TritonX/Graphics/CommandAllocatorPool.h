@@ -0,0 +1,180 @@
+//
+// CommandAllocatorPool.h - Command allocators recycled once the GPU fence passes their last use
+//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "Graphics/Device.h"
+#include "System/MpscQueue.h"
+
+namespace TX::Graphics {
+
+   // An allocator checked out of a CommandAllocatorPool. id identifies it when releasing.
+   struct PooledCommandAllocator {
+      CommandAllocator* allocator;
+      uint32_t id;
+   };
+
+   // Grows to however many allocators are actually recording at once instead of provisioning
+   // the worst case per frame. Released allocators wait, in release order, until the queue's fence
+   // reaches the value they were tagged with, then become available to any thread again.
+   // Acquire and Release never take a lock and may be called from any thread; Trim is meant for
+   // the submitting thread.
+   class CommandAllocatorPool {
+    public:
+      // capacity bounds how many allocators can exist at once. Bookkeeping for all of them is
+      // allocated up front, the allocators themselves only on demand.
+      explicit CommandAllocatorPool(Device& device, uint32_t capacity = 256) :
+          device(device), capacity(capacity), nodes(std::make_unique<Node[]>(capacity)),
+          pending(capacity) {
+      }
+
+      CommandAllocatorPool(const CommandAllocatorPool&) = delete;
+      CommandAllocatorPool& operator=(const CommandAllocatorPool&) = delete;
+
+      // Returns a reset allocator whose previous work the GPU has finished, creating one if none
+      // is free. Throws std::runtime_error if capacity allocators are already in existence.
+      PooledCommandAllocator Acquire() {
+         RetireCompleted();
+
+         uint32_t id = 0;
+         if (ready.Pop(nodes.get(), id)) {
+            nodes[id].allocator->Reset();
+            return {nodes[id].allocator.get(), id};
+         }
+
+         if (!unused.Pop(nodes.get(), id)) {
+            id = created.fetch_add(1, std::memory_order_relaxed);
+            if (id >= capacity) {
+               created.fetch_sub(1, std::memory_order_relaxed);
+               throw std::runtime_error("CommandAllocatorPool capacity exhausted");
+            }
+         }
+         nodes[id].allocator = device.CreateCommandAllocator();
+         allocatorCount.fetch_add(1, std::memory_order_relaxed);
+         return {nodes[id].allocator.get(), id};
+      }
+
+      // Hands allocator back. It is not reused until the queue's fence reaches fenceValue.
+      void Release(const PooledCommandAllocator& allocator, uint64_t fenceValue) {
+         nodes[allocator.id].fenceValue = fenceValue;
+         // pending holds every node, and a node is only ever queued once at a time.
+         [[maybe_unused]] const bool queued =
+             pending.TryPush([&](uint32_t& id) { id = allocator.id; });
+         assert(queued);
+      }
+
+      // Destroys free allocators whose last use is more than maxIdleFences fence values behind the
+      // queue, so the pool shrinks back after a burst of demand.
+      void Trim(uint64_t maxIdleFences) {
+         RetireCompleted();
+         const uint64_t completedValue = device.GetQueue().GetCompletedValue();
+
+         uint32_t keep = NoNode;
+         uint32_t id = 0;
+         while (ready.Pop(nodes.get(), id)) {
+            if (completedValue - nodes[id].fenceValue > maxIdleFences) {
+               nodes[id].allocator.reset();
+               allocatorCount.fetch_sub(1, std::memory_order_relaxed);
+               unused.Push(nodes.get(), id);
+            } else {
+               nodes[id].next.store(keep, std::memory_order_relaxed);
+               keep = id;
+            }
+         }
+         while (keep != NoNode) {
+            id = keep;
+            keep = nodes[id].next.load(std::memory_order_relaxed);
+            ready.Push(nodes.get(), id);
+         }
+      }
+
+      // Allocators currently alive, whether checked out, waiting on the GPU or free.
+      [[nodiscard]] uint32_t GetAllocatorCount() const noexcept {
+         return allocatorCount.load(std::memory_order_relaxed);
+      }
+
+    private:
+      static constexpr uint32_t NoNode = UINT32_MAX;
+
+      struct Node {
+         std::unique_ptr<CommandAllocator> allocator;
+         uint64_t fenceValue{0};
+         std::atomic<uint32_t> next{NoNode};
+      };
+
+      // Treiber stack of node ids. The head packs a change count next to the id so a node that is
+      // popped and pushed back between another thread's load and compare exchange is noticed.
+      class NodeStack {
+       public:
+         void Push(Node* nodes, uint32_t id) noexcept {
+            uint64_t head = top.load(std::memory_order_relaxed);
+            uint64_t newHead = 0;
+            do {
+               nodes[id].next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+               newHead = Pack(head, id);
+            } while (!top.compare_exchange_weak(
+                head, newHead, std::memory_order_release, std::memory_order_relaxed));
+         }
+
+         bool Pop(Node* nodes, uint32_t& id) noexcept {
+            uint64_t head = top.load(std::memory_order_acquire);
+            while (static_cast<uint32_t>(head) != NoNode) {
+               const auto candidate = static_cast<uint32_t>(head);
+               const uint32_t next = nodes[candidate].next.load(std::memory_order_relaxed);
+               if (top.compare_exchange_weak(head,
+                                             Pack(head, next),
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+                  id = candidate;
+                  return true;
+               }
+            }
+            return false;
+         }
+
+       private:
+         std::atomic<uint64_t> top{NoNode};
+
+         static uint64_t Pack(uint64_t previous, uint32_t id) noexcept {
+            return (((previous >> 32) + 1) << 32) | id;
+         }
+      };
+
+      Device& device;
+      const uint32_t capacity;
+      std::unique_ptr<Node[]> nodes;
+
+      // Released, in release order, waiting for the fence.
+      MpscQueue<uint32_t> pending;
+      std::atomic_flag retiring;
+      // Free for reuse.
+      NodeStack ready;
+      // Trimmed nodes whose allocator was destroyed, reused before growing.
+      NodeStack unused;
+      std::atomic<uint32_t> created{0};
+      std::atomic<uint32_t> allocatorCount{0};
+
+      // Moves released allocators whose fence has passed onto the ready stack. Only one thread
+      // does this at a time; any other caller skips it rather than wait.
+      void RetireCompleted() {
+         if (retiring.test_and_set(std::memory_order_acquire)) {
+            return;
+         }
+         const uint64_t completedValue = device.GetQueue().GetCompletedValue();
+         const auto completed = [&](uint32_t id) {
+            return nodes[id].fenceValue <= completedValue;
+         };
+         const auto makeReady = [&](uint32_t id) { ready.Push(nodes.get(), id); };
+         while (pending.TryPopIf(completed, makeReady)) {
+         }
+         retiring.clear(std::memory_order_release);
+      }
+   };
+}
@@ -0,0 +1,154 @@
+//
+// CommandRecorder.h - Per frame command lists that worker threads record into in parallel
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Graphics/CommandAllocatorPool.h"
+#include "Graphics/Device.h"
+#include "Graphics/ResourceStateTracker.h"
+
+namespace TX::Graphics {
+
+   // Hands out one command list per submission index for the current frame, each recording into
+   // an allocator from a fence tracked pool. Each index belongs to exactly one thread for the
+   // frame, so recording needs no locking, and Submit sends everything in index order regardless
+   // of which thread finished first.
+   //
+   // Each list also has a ResourceStateTracker. Submit flushes what it still holds and resolves
+   // the states every list expects on entry in submission order. The transitions a list needs go
+   // at the end of the list before it. List 0 is always submitted first, so its tracker leads and
+   // records them in the list itself as it goes. Only when list 0 is left unused does the first
+   // list need a small prologue list for them.
+   //
+   //    recorder.BeginFrame(workerCount);
+   //    parallel for i: Record(recorder.Open(i), recorder.GetStateTracker(i));
+   //    recorder.Submit(queue, fenceValue);
+   class CommandRecorder {
+    public:
+      // Free allocators unused for this many fence values are destroyed.
+      static constexpr uint64_t MaxIdleFences = 240;
+
+      explicit CommandRecorder(Device& device) : device(device), allocatorPool(device) {
+      }
+
+      // Makes count lists available for this frame, creating lists on first use. Call from the
+      // submitting thread before handing indices out.
+      void BeginFrame(uint32_t count) {
+         while (commandLists.size() < count) {
+            commandLists.push_back(device.CreateCommandList());
+         }
+         stateTrackers.resize(std::max<size_t>(stateTrackers.size(), count));
+         allocators.resize(count);
+         opened.assign(count, 0);
+
+         listCount = count;
+      }
+
+      // Takes an allocator whose previous work the GPU has finished and opens the list at index
+      // for recording into it. Safe to call from different threads for different indices between
+      // BeginFrame and Submit.
+      CommandList& Open(uint32_t index) {
+         allocators[index] = allocatorPool.Acquire();
+         auto& commandList = *commandLists[index];
+         commandList.Reset(*allocators[index].allocator);
+         stateTrackers[index].Reset(index == 0);
+         opened[index] = 1;
+         return commandList;
+      }
+
+      // Tracks the states the list at index needs. Same threading rules as Open.
+      [[nodiscard]] ResourceStateTracker& GetStateTracker(uint32_t index) noexcept {
+         return stateTrackers[index];
+      }
+
+      // Closes every list opened this frame and submits them, in index order, in one Execute.
+      // fenceValue is the value the caller signals on queue after this submission; the allocators
+      // used this frame are not reused before the fence reaches it. All recording threads must
+      // have finished.
+      void Submit(Queue& queue, uint64_t fenceValue) {
+         submission.clear();
+         CommandList* previous = nullptr;
+         for (uint32_t index = 0; index < listCount; index++) {
+            if (!opened[index]) {
+               continue;
+            }
+            CommandList& commandList = *commandLists[index];
+            auto& states = stateTrackers[index];
+            states.Flush(commandList);
+
+            entryBarriers.clear();
+            states.Resolve(entryBarriers);
+            if (!entryBarriers.empty()) {
+               if (previous) {
+                  previous->Barriers(entryBarriers);
+               } else {
+                  submission.push_back(&RecordPrologue());
+               }
+            }
+
+            if (previous) {
+               previous->Close();
+               submission.push_back(previous);
+            }
+            previous = &commandList;
+         }
+         if (previous) {
+            previous->Close();
+            submission.push_back(previous);
+            queue.Execute(submission);
+         }
+
+         for (uint32_t index = 0; index < listCount; index++) {
+            if (opened[index]) {
+               allocatorPool.Release(allocators[index], fenceValue);
+            }
+         }
+         if (prologueOpened) {
+            allocatorPool.Release(prologueAllocator, fenceValue);
+            prologueOpened = false;
+         }
+         allocatorPool.Trim(MaxIdleFences);
+         listCount = 0;
+      }
+
+      [[nodiscard]] const CommandAllocatorPool& GetAllocatorPool() const noexcept {
+         return allocatorPool;
+      }
+
+    private:
+      Device& device;
+      CommandAllocatorPool allocatorPool;
+
+      std::vector<std::unique_ptr<CommandList>> commandLists;
+      std::vector<ResourceStateTracker> stateTrackers;
+      std::vector<PooledCommandAllocator> allocators;
+      // Not vector<bool>, so that workers setting neighbouring entries do not race.
+      std::vector<uint8_t> opened;
+      std::vector<CommandList*> submission;
+
+      std::unique_ptr<CommandList> prologue;
+      PooledCommandAllocator prologueAllocator{};
+      bool prologueOpened{false};
+      std::vector<TextureBarrier> entryBarriers;
+
+      uint32_t listCount{0};
+
+      CommandList& RecordPrologue() {
+         if (!prologue) {
+            prologue = device.CreateCommandList();
+         }
+         prologueAllocator = allocatorPool.Acquire();
+         prologue->Reset(*prologueAllocator.allocator);
+         prologueOpened = true;
+         prologue->Barriers(entryBarriers);
+         prologue->Close();
+         return *prologue;
+      }
+   };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "StepTimer.h"
+#include "Graphics/D3D12Device.h"
+#include "Graphics/Renderer.h"
 
 namespace TX::Graphics {
 
@@ -19,6 +20,10 @@ namespace TX::Graphics {
       void Initialize(HWND window, int width, int height);
       void Tick();
 
+      // Run the fixed step Update loop on a dedicated thread instead of inside Tick(). Update then
+      // executes off the message pump thread and must only touch state it returns.
+      void SetThreadedSimulation(bool threaded);
+
       // Messages
       void OnActivated();
       void OnDeactivated();
@@ -27,8 +32,6 @@ namespace TX::Graphics {
       void OnWindowSizeChanged(int width, int height);
 
     private:
-      static const UINT swapBufferCount = 2;
-
       HWND window;
       int outputWidth;
       int outputHeight;
@@ -37,44 +40,7 @@ namespace TX::Graphics {
       /// </summary>
       RECT prevRect;
 
-      Microsoft::WRL::ComPtr<IDXGIFactory4> dxgiFactory;
-      Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice;
-
-      Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue;
-
-      Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> rtvDescriptorHeap;
-      Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvDescriptorHeap;
-
-      std::array<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>, swapBufferCount> commandAllocators;
-      Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
-
-      Microsoft::WRL::ComPtr<ID3D12Fence> fence;
-      Microsoft::WRL::Wrappers::Event fenceEvent;
-
-      std::array<UINT64, swapBufferCount> fenceValues;
-
-      Microsoft::WRL::ComPtr<IDXGISwapChain3> swapChain;
-      std::array<Microsoft::WRL::ComPtr<ID3D12Resource>, swapBufferCount> renderTargets;
-      Microsoft::WRL::ComPtr<ID3D12Resource> depthStencil;
-
-      StepTimer timer;
-
-      UINT rtvDescriptorSize;
-      UINT backBufferIndex;
-
-      D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
-
-      void CreateDevice();
-      void GetAdapter(IDXGIAdapter1** ppAdapter);
-      void CreateResources();
-      void WaitForGpu() noexcept;
-
-      void OnDeviceLost();
-
-      void Update(StepTimer const& timer);
-      void Render();
-      void Clear();
-      void Present();
-      void MoveToNextFrame();
+      std::unique_ptr<D3D12Device> device;
+      std::unique_ptr<Renderer> renderer;
    };
 }
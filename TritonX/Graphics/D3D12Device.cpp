@@ -0,0 +1,928 @@
+#include "pch.h"
+
+#include <utility>
+
+#include "D3D12Device.h"
+#include "Graphics/BarrierTranslation.h"
+#include "Helpers.h"
+#include "Logger.h"
+
+namespace TX::Graphics {
+
+   using Microsoft::WRL::ComPtr;
+
+   namespace {
+      constexpr DXGI_FORMAT backBufferFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+      constexpr DXGI_FORMAT depthBufferFormat = DXGI_FORMAT_D32_FLOAT;
+      // Descriptors per CPU descriptor heap. CPU heaps are cheap, so pages are sized to make
+      // growing rare rather than to be tight.
+      constexpr uint32_t descriptorPageSize = 256;
+
+      D3D12_RESOURCE_STATES ToD3D12(ResourceState state) noexcept {
+         switch (state) {
+            case ResourceState::Common:
+               return D3D12_RESOURCE_STATE_COMMON;
+            case ResourceState::Present:
+               return D3D12_RESOURCE_STATE_PRESENT;
+            case ResourceState::RenderTarget:
+               return D3D12_RESOURCE_STATE_RENDER_TARGET;
+            case ResourceState::DepthWrite:
+               return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+            case ResourceState::DepthRead:
+               return D3D12_RESOURCE_STATE_DEPTH_READ;
+            case ResourceState::ShaderResource:
+               return D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
+            case ResourceState::UnorderedAccess:
+               return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            case ResourceState::CopySource:
+               return D3D12_RESOURCE_STATE_COPY_SOURCE;
+            case ResourceState::CopyDest:
+               return D3D12_RESOURCE_STATE_COPY_DEST;
+         }
+         return D3D12_RESOURCE_STATE_COMMON;
+      }
+
+#if D3D12_SDK_VERSION >= 608
+      D3D12_BARRIER_SYNC ToD3D12(BarrierSync sync) noexcept {
+         switch (sync) {
+            case BarrierSync::None:
+               return D3D12_BARRIER_SYNC_NONE;
+            case BarrierSync::All:
+               return D3D12_BARRIER_SYNC_ALL;
+            case BarrierSync::RenderTarget:
+               return D3D12_BARRIER_SYNC_RENDER_TARGET;
+            case BarrierSync::DepthStencil:
+               return D3D12_BARRIER_SYNC_DEPTH_STENCIL;
+            case BarrierSync::AllShading:
+               return D3D12_BARRIER_SYNC_ALL_SHADING;
+            case BarrierSync::Copy:
+               return D3D12_BARRIER_SYNC_COPY;
+         }
+         return D3D12_BARRIER_SYNC_ALL;
+      }
+
+      D3D12_BARRIER_ACCESS ToD3D12(BarrierAccess access) noexcept {
+         switch (access) {
+            case BarrierAccess::NoAccess:
+               return D3D12_BARRIER_ACCESS_NO_ACCESS;
+            case BarrierAccess::Common:
+               return D3D12_BARRIER_ACCESS_COMMON;
+            case BarrierAccess::RenderTarget:
+               return D3D12_BARRIER_ACCESS_RENDER_TARGET;
+            case BarrierAccess::DepthStencilWrite:
+               return D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE;
+            case BarrierAccess::DepthStencilRead:
+               return D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ;
+            case BarrierAccess::ShaderResource:
+               return D3D12_BARRIER_ACCESS_SHADER_RESOURCE;
+            case BarrierAccess::UnorderedAccess:
+               return D3D12_BARRIER_ACCESS_UNORDERED_ACCESS;
+            case BarrierAccess::CopySource:
+               return D3D12_BARRIER_ACCESS_COPY_SOURCE;
+            case BarrierAccess::CopyDest:
+               return D3D12_BARRIER_ACCESS_COPY_DEST;
+         }
+         return D3D12_BARRIER_ACCESS_COMMON;
+      }
+
+      D3D12_BARRIER_LAYOUT ToD3D12(BarrierLayout layout) noexcept {
+         switch (layout) {
+            case BarrierLayout::Common:
+               return D3D12_BARRIER_LAYOUT_COMMON;
+            case BarrierLayout::Present:
+               return D3D12_BARRIER_LAYOUT_PRESENT;
+            case BarrierLayout::RenderTarget:
+               return D3D12_BARRIER_LAYOUT_RENDER_TARGET;
+            case BarrierLayout::DepthStencilWrite:
+               return D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE;
+            case BarrierLayout::DepthStencilRead:
+               return D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ;
+            case BarrierLayout::ShaderResource:
+               return D3D12_BARRIER_LAYOUT_SHADER_RESOURCE;
+            case BarrierLayout::UnorderedAccess:
+               return D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS;
+            case BarrierLayout::CopySource:
+               return D3D12_BARRIER_LAYOUT_COPY_SOURCE;
+            case BarrierLayout::CopyDest:
+               return D3D12_BARRIER_LAYOUT_COPY_DEST;
+         }
+         return D3D12_BARRIER_LAYOUT_COMMON;
+      }
+#endif
+
+      DXGI_FORMAT ToDxgi(TextureFormat format) noexcept {
+         switch (format) {
+            case TextureFormat::Bgra8Unorm:
+               return DXGI_FORMAT_B8G8R8A8_UNORM;
+            case TextureFormat::Rgba16Float:
+               return DXGI_FORMAT_R16G16B16A16_FLOAT;
+            case TextureFormat::D32Float:
+               return DXGI_FORMAT_D32_FLOAT;
+         }
+         return DXGI_FORMAT_UNKNOWN;
+      }
+
+      D3D12_RESOURCE_DESC ToResourceDesc(const TextureDesc& desc) noexcept {
+         D3D12_RESOURCE_DESC resourceDesc =
+             CD3DX12_RESOURCE_DESC::Tex2D(ToDxgi(desc.format), desc.width, desc.height, 1, 1);
+         resourceDesc.Flags |= desc.usage == TextureUsage::DepthStencil
+                                   ? D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL
+                                   : D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+         return resourceDesc;
+      }
+
+      D3D12Texture& Native(Texture& texture) noexcept {
+         return static_cast<D3D12Texture&>(texture);
+      }
+   }
+
+   D3D12Descriptor::D3D12Descriptor(D3D12DescriptorAllocator* allocator,
+                                    DescriptorRange range,
+                                    D3D12_CPU_DESCRIPTOR_HANDLE handle) noexcept :
+       allocator(allocator), range(range), handle(handle) {
+   }
+
+   D3D12Descriptor::~D3D12Descriptor() {
+      if (allocator) {
+         allocator->allocator.Free(range);
+      }
+   }
+
+   D3D12Descriptor::D3D12Descriptor(D3D12Descriptor&& other) noexcept :
+       allocator(std::exchange(other.allocator, nullptr)), range(other.range),
+       handle(other.handle) {
+   }
+
+   D3D12Descriptor& D3D12Descriptor::operator=(D3D12Descriptor&& other) noexcept {
+      if (this != &other) {
+         if (allocator) {
+            allocator->allocator.Free(range);
+         }
+         allocator = std::exchange(other.allocator, nullptr);
+         range = other.range;
+         handle = other.handle;
+      }
+      return *this;
+   }
+
+   D3D12_CPU_DESCRIPTOR_HANDLE D3D12Descriptor::Get(uint32_t index) const noexcept {
+      return CD3DX12_CPU_DESCRIPTOR_HANDLE(
+          handle, static_cast<INT>(index), allocator ? allocator->descriptorSize : 0);
+   }
+
+   D3D12DescriptorAllocator::D3D12DescriptorAllocator(ID3D12Device* d3dDevice,
+                                                      D3D12_DESCRIPTOR_HEAP_TYPE type,
+                                                      uint32_t pageSize) :
+       d3dDevice(d3dDevice), type(type),
+       descriptorSize(d3dDevice->GetDescriptorHandleIncrementSize(type)), heapStarts{},
+       allocator(pageSize, [this, pageSize](uint32_t page) {
+          const auto heapDesc = D3D12_DESCRIPTOR_HEAP_DESC{
+              .Type = this->type,
+              .NumDescriptors = pageSize,
+          };
+          ThrowIfFailed(this->d3dDevice->CreateDescriptorHeap(
+              &heapDesc, IID_PPV_ARGS(heaps[page].ReleaseAndGetAddressOf())));
+          heapStarts[page] = heaps[page]->GetCPUDescriptorHandleForHeapStart();
+       }) {
+   }
+
+   D3D12Descriptor D3D12DescriptorAllocator::Allocate(uint32_t count) {
+      const DescriptorRange range = allocator.Allocate(count);
+      const CD3DX12_CPU_DESCRIPTOR_HANDLE handle(
+          heapStarts[range.page], static_cast<INT>(range.first), descriptorSize);
+      return {this, range, handle};
+   }
+
+   D3D12DescriptorTableRing::D3D12DescriptorTableRing(ID3D12Device* d3dDevice,
+                                                      Timeline& timeline,
+                                                      uint32_t slotsPerFrame,
+                                                      uint32_t frameCount) :
+       d3dDevice(d3dDevice),
+       descriptorSize(
+           d3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)),
+       cpuStart{}, gpuStart{}, ring(timeline, slotsPerFrame, frameCount) {
+      const auto heapDesc = D3D12_DESCRIPTOR_HEAP_DESC{
+          .Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+          .NumDescriptors = ring.GetSlotCount(),
+          .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+      };
+      ThrowIfFailed(
+          d3dDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(heap.ReleaseAndGetAddressOf())));
+      heap->SetName(L"Descriptor Table Ring");
+      cpuStart = heap->GetCPUDescriptorHandleForHeapStart();
+      gpuStart = heap->GetGPUDescriptorHandleForHeapStart();
+   }
+
+   D3D12_GPU_DESCRIPTOR_HANDLE D3D12DescriptorTableRing::Stage(
+       std::span<const D3D12_CPU_DESCRIPTOR_HANDLE> sources) {
+      stagedSources.clear();
+      for (const auto& source : sources) {
+         stagedSources.push_back(source.ptr);
+      }
+      const uint32_t slot = ring.Stage(stagedSources);
+      return CD3DX12_GPU_DESCRIPTOR_HANDLE(gpuStart, static_cast<INT>(slot), descriptorSize);
+   }
+
+   void D3D12DescriptorTableRing::Flush() {
+      const auto copies = ring.TakeCopies();
+      if (copies.empty()) {
+         return;
+      }
+      const auto sources = ring.GetSources();
+
+      destStarts.clear();
+      destSizes.clear();
+      sourceStarts.clear();
+      sourceSizes.clear();
+      for (const auto& copy : copies) {
+         destStarts.push_back(CD3DX12_CPU_DESCRIPTOR_HANDLE(
+             cpuStart, static_cast<INT>(copy.firstSlot), descriptorSize));
+         destSizes.push_back(copy.count);
+         // Sources are usually allocated together, so runs of adjacent ones copy as one range.
+         for (uint32_t s = copy.firstSource; s < copy.firstSource + copy.count; s++) {
+            const SIZE_T source = static_cast<SIZE_T>(sources[s]);
+            if (!sourceStarts.empty() &&
+                sourceStarts.back().ptr + SIZE_T{sourceSizes.back()} * descriptorSize == source) {
+               sourceSizes.back()++;
+            } else {
+               sourceStarts.push_back({source});
+               sourceSizes.push_back(1);
+            }
+         }
+      }
+
+      d3dDevice->CopyDescriptors(static_cast<UINT>(destStarts.size()),
+                                 destStarts.data(),
+                                 destSizes.data(),
+                                 static_cast<UINT>(sourceStarts.size()),
+                                 sourceStarts.data(),
+                                 sourceSizes.data(),
+                                 D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+   }
+
+   D3D12BindlessTable::D3D12BindlessTable(ID3D12Device* d3dDevice,
+                                          Timeline& timeline,
+                                          uint32_t capacity) :
+       d3dDevice(d3dDevice),
+       descriptorSize(
+           d3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)),
+       cpuStart{}, gpuStart{}, slots(timeline, capacity) {
+      const auto heapDesc = D3D12_DESCRIPTOR_HEAP_DESC{
+          .Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+          .NumDescriptors = capacity,
+          .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+      };
+      ThrowIfFailed(
+          d3dDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(heap.ReleaseAndGetAddressOf())));
+      heap->SetName(L"Bindless Heap");
+      cpuStart = heap->GetCPUDescriptorHandleForHeapStart();
+      gpuStart = heap->GetGPUDescriptorHandleForHeapStart();
+
+      CreateRootSignature(capacity);
+   }
+
+   void D3D12BindlessTable::CreateRootSignature(uint32_t capacity) {
+      D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+      ThrowIfFailed(d3dDevice->CheckFeatureSupport(
+          D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)));
+      if (options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_2) {
+         throw std::runtime_error("Bindless resources need resource binding tier 2");
+      }
+      const bool unorderedAccess = options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_3;
+
+      D3D12_FEATURE_DATA_ROOT_SIGNATURE rootSignatureVersion = {D3D_ROOT_SIGNATURE_VERSION_1_1};
+      if (FAILED(d3dDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE,
+                                                &rootSignatureVersion,
+                                                sizeof(rootSignatureVersion)))) {
+         rootSignatureVersion.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+      }
+
+      // Slots are written while the GPU may be executing work that indexes other slots, so the
+      // descriptors cannot be declared static.
+      constexpr auto volatileFlags = D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE |
+                                     D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+      // Unbounded ranges may only be followed by ranges with an explicit offset, which these
+      // all have.
+      const std::array<CD3DX12_DESCRIPTOR_RANGE1, 4> ranges = {
+          CD3DX12_DESCRIPTOR_RANGE1(
+              D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 1, volatileFlags, 0),
+          CD3DX12_DESCRIPTOR_RANGE1(
+              D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 2, volatileFlags, 0),
+          CD3DX12_DESCRIPTOR_RANGE1(
+              D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, 3, volatileFlags, 0),
+          CD3DX12_DESCRIPTOR_RANGE1(
+              D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, 4, volatileFlags, 0),
+      };
+
+      std::array<CD3DX12_ROOT_PARAMETER1, 2> parameters;
+      parameters[TableParameter].InitAsDescriptorTable(unorderedAccess ? 4 : 2, ranges.data());
+      parameters[ConstantsParameter].InitAsConstants(RootConstantCount, 0);
+
+      CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+      rootSignatureDesc.Init_1_1(static_cast<UINT>(parameters.size()),
+                                 parameters.data(),
+                                 0,
+                                 nullptr,
+                                 D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+      ComPtr<ID3DBlob> signature;
+      ComPtr<ID3DBlob> error;
+      const HRESULT hr = D3DX12SerializeVersionedRootSignature(&rootSignatureDesc,
+                                                               rootSignatureVersion.HighestVersion,
+                                                               signature.GetAddressOf(),
+                                                               error.GetAddressOf());
+      if (FAILED(hr) && error) {
+         TX_LOG(Error, Graphics) << L"Bindless root signature: "
+                                 << static_cast<const char*>(error->GetBufferPointer())
+                                 << std::endl;
+      }
+      ThrowIfFailed(hr);
+      ThrowIfFailed(d3dDevice->CreateRootSignature(0,
+                                                   signature->GetBufferPointer(),
+                                                   signature->GetBufferSize(),
+                                                   IID_PPV_ARGS(rootSignature.GetAddressOf())));
+      rootSignature->SetName(L"Bindless Root Signature");
+
+      TX_LOG(Info, Graphics) << L"Bindless heap of " << capacity << L" descriptors"
+                             << (unorderedAccess ? L"" : L", without unordered access arrays")
+                             << std::endl;
+   }
+
+   BindlessHandle D3D12BindlessTable::AddShaderResource(
+       ID3D12Resource* resource,
+       const D3D12_SHADER_RESOURCE_VIEW_DESC* desc) {
+      const BindlessHandle handle = slots.Allocate();
+      d3dDevice->CreateShaderResourceView(
+          resource,
+          desc,
+          CD3DX12_CPU_DESCRIPTOR_HANDLE(cpuStart, static_cast<INT>(handle.index), descriptorSize));
+      return handle;
+   }
+
+   BindlessHandle D3D12BindlessTable::AddUnorderedAccess(
+       ID3D12Resource* resource,
+       const D3D12_UNORDERED_ACCESS_VIEW_DESC* desc) {
+      const BindlessHandle handle = slots.Allocate();
+      d3dDevice->CreateUnorderedAccessView(
+          resource,
+          nullptr,
+          desc,
+          CD3DX12_CPU_DESCRIPTOR_HANDLE(cpuStart, static_cast<INT>(handle.index), descriptorSize));
+      return handle;
+   }
+
+   void D3D12BindlessTable::Remove(BindlessHandle handle) {
+      slots.Release(handle);
+   }
+
+   void D3D12BindlessTable::Collect() {
+      slots.Collect();
+   }
+
+   void D3D12BindlessTable::Bind(ID3D12GraphicsCommandList* commandList) const {
+      ID3D12DescriptorHeap* heaps[] = {heap.Get()};
+      commandList->SetDescriptorHeaps(1, heaps);
+      commandList->SetGraphicsRootSignature(rootSignature.Get());
+      commandList->SetGraphicsRootDescriptorTable(TableParameter, gpuStart);
+   }
+
+   D3D12Texture::D3D12Texture(ComPtr<ID3D12Resource> resource,
+                              ResourceState initialState,
+                              D3D12Descriptor view) :
+       Texture(initialState), resource(std::move(resource)), view(std::move(view)) {
+   }
+
+   uint32_t D3D12Texture::GetWidth() const noexcept {
+      return static_cast<uint32_t>(resource->GetDesc().Width);
+   }
+
+   uint32_t D3D12Texture::GetHeight() const noexcept {
+      return resource->GetDesc().Height;
+   }
+
+   D3D12UploadBuffer::D3D12UploadBuffer(ID3D12Device* d3dDevice, uint64_t size) :
+       mappedData(nullptr), size(size) {
+      const CD3DX12_HEAP_PROPERTIES uploadHeapProperties(D3D12_HEAP_TYPE_UPLOAD);
+      const D3D12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+      ThrowIfFailed(d3dDevice->CreateCommittedResource(&uploadHeapProperties,
+                                                       D3D12_HEAP_FLAG_NONE,
+                                                       &bufferDesc,
+                                                       D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                       nullptr,
+                                                       IID_PPV_ARGS(resource.GetAddressOf())));
+      resource->SetName(L"Upload Buffer");
+
+      // Upload heaps may stay mapped while the GPU reads them. The empty read range tells the
+      // driver the CPU will not read back. Releasing the resource unmaps it.
+      const CD3DX12_RANGE readRange(0, 0);
+      void* data = nullptr;
+      ThrowIfFailed(resource->Map(0, &readRange, &data));
+      mappedData = static_cast<std::byte*>(data);
+   }
+
+   D3D12Heap::D3D12Heap(ID3D12Device* d3dDevice, uint64_t size) : size(size) {
+      // Tier 1 hardware cannot mix render targets with other textures or buffers in one heap.
+      const CD3DX12_HEAP_DESC heapDesc(size,
+                                       D3D12_HEAP_TYPE_DEFAULT,
+                                       D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+                                       D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
+      ThrowIfFailed(d3dDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(heap.ReleaseAndGetAddressOf())));
+   }
+
+   D3D12CommandAllocator::D3D12CommandAllocator(ID3D12Device* d3dDevice) {
+      ThrowIfFailed(d3dDevice->CreateCommandAllocator(
+          D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(allocator.ReleaseAndGetAddressOf())));
+   }
+
+   void D3D12CommandAllocator::Reset() {
+      ThrowIfFailed(allocator->Reset());
+   }
+
+   D3D12CommandList::D3D12CommandList(ID3D12Device* d3dDevice, bool enhancedBarriers) {
+      // CreateCommandList1 creates the list closed and without an allocator, so none has to be
+      // kept alive just for creation.
+      ComPtr<ID3D12Device4> device4;
+      ThrowIfFailed(d3dDevice->QueryInterface(IID_PPV_ARGS(device4.GetAddressOf())));
+      ThrowIfFailed(
+          device4->CreateCommandList1(0,
+                                      D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                      D3D12_COMMAND_LIST_FLAG_NONE,
+                                      IID_PPV_ARGS(commandList.ReleaseAndGetAddressOf())));
+
+#if D3D12_SDK_VERSION >= 608
+      if (enhancedBarriers) {
+         ThrowIfFailed(commandList.As(&commandList7));
+      }
+#else
+      (void)enhancedBarriers;
+#endif
+   }
+
+   void D3D12CommandList::Reset(CommandAllocator& allocator) {
+      ThrowIfFailed(
+          commandList->Reset(static_cast<D3D12CommandAllocator&>(allocator).Get(), nullptr));
+   }
+
+   void D3D12CommandList::Close() {
+      ThrowIfFailed(commandList->Close());
+   }
+
+   void D3D12CommandList::Barriers(std::span<const TextureBarrier> barriers) {
+      if (barriers.empty()) {
+         return;
+      }
+
+#if D3D12_SDK_VERSION >= 608
+      if (commandList7) {
+         textureBarrierBatch.clear();
+         for (const auto& barrier : barriers) {
+            const ScopedTextureBarrier scoped = ToScopedBarrier(barrier);
+            textureBarrierBatch.push_back(
+                CD3DX12_TEXTURE_BARRIER(ToD3D12(scoped.before.sync),
+                                        ToD3D12(scoped.after.sync),
+                                        ToD3D12(scoped.before.access),
+                                        ToD3D12(scoped.after.access),
+                                        ToD3D12(scoped.before.layout),
+                                        ToD3D12(scoped.after.layout),
+                                        Native(*barrier.texture).GetResource(),
+                                        CD3DX12_BARRIER_SUBRESOURCE_RANGE(0xffffffff)));
+         }
+         const CD3DX12_BARRIER_GROUP group(static_cast<UINT32>(textureBarrierBatch.size()),
+                                           textureBarrierBatch.data());
+         commandList7->Barrier(1, &group);
+         return;
+      }
+#endif
+
+      barrierBatch.clear();
+      for (const auto& barrier : barriers) {
+         barrierBatch.push_back(
+             CD3DX12_RESOURCE_BARRIER::Transition(Native(*barrier.texture).GetResource(),
+                                                  ToD3D12(barrier.before),
+                                                  ToD3D12(barrier.after)));
+      }
+      commandList->ResourceBarrier(static_cast<UINT>(barrierBatch.size()), barrierBatch.data());
+   }
+
+   // Legacy aliasing barriers are valid alongside enhanced barriers, so both paths use them.
+   void D3D12CommandList::AliasingBarriers(std::span<const AliasingBarrier> barriers) {
+      if (barriers.empty()) {
+         return;
+      }
+      barrierBatch.clear();
+      for (const auto& barrier : barriers) {
+         barrierBatch.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(
+             barrier.before ? Native(*barrier.before).GetResource() : nullptr,
+             Native(*barrier.after).GetResource()));
+      }
+      commandList->ResourceBarrier(static_cast<UINT>(barrierBatch.size()), barrierBatch.data());
+   }
+
+   void D3D12CommandList::SetRenderTarget(Texture& color, Texture* depth) {
+      const D3D12_CPU_DESCRIPTOR_HANDLE rtvDescriptor = Native(color).GetView();
+      D3D12_CPU_DESCRIPTOR_HANDLE dsvDescriptor = {};
+      if (depth) {
+         dsvDescriptor = Native(*depth).GetView();
+      }
+      commandList->OMSetRenderTargets(1, &rtvDescriptor, FALSE, depth ? &dsvDescriptor : nullptr);
+   }
+
+   void D3D12CommandList::ClearRenderTarget(Texture& color, const ClearColor& value) {
+      commandList->ClearRenderTargetView(Native(color).GetView(), value.data(), 0, nullptr);
+   }
+
+   void D3D12CommandList::ClearDepth(Texture& depth, float value) {
+      commandList->ClearDepthStencilView(
+          Native(depth).GetView(), D3D12_CLEAR_FLAG_DEPTH, value, 0, 0, nullptr);
+   }
+
+   void D3D12CommandList::SetViewport(uint32_t width, uint32_t height) {
+      const D3D12_VIEWPORT viewport = {0.0f,
+                                       0.0f,
+                                       static_cast<float>(width),
+                                       static_cast<float>(height),
+                                       D3D12_MIN_DEPTH,
+                                       D3D12_MAX_DEPTH};
+      const D3D12_RECT scissorRect = {0, 0, static_cast<LONG>(width), static_cast<LONG>(height)};
+      commandList->RSSetViewports(1, &viewport);
+      commandList->RSSetScissorRects(1, &scissorRect);
+   }
+
+   D3D12Queue::D3D12Queue(ID3D12Device* d3dDevice) {
+      // Create the Command Queue
+      auto queueDesc = D3D12_COMMAND_QUEUE_DESC{.Type = D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                .Flags = D3D12_COMMAND_QUEUE_FLAG_NONE};
+
+      ThrowIfFailed(d3dDevice->CreateCommandQueue(
+          &queueDesc, IID_PPV_ARGS(commandQueue.ReleaseAndGetAddressOf())));
+
+      // Create a fence for tracking GPU execution
+      ThrowIfFailed(d3dDevice->CreateFence(
+          0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(fence.ReleaseAndGetAddressOf())));
+
+      fenceEvent.Attach(CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE));
+
+      if (!fenceEvent.IsValid()) {
+         throw std::system_error(
+             std::error_code(static_cast<int>(GetLastError()), std::system_category()),
+             "CreateEventEx");
+      }
+   }
+
+   void D3D12Queue::Execute(std::span<CommandList* const> commandLists) {
+      submission.clear();
+      for (CommandList* commandList : commandLists) {
+         submission.push_back(static_cast<D3D12CommandList*>(commandList)->Get());
+      }
+      commandQueue->ExecuteCommandLists(static_cast<UINT>(submission.size()), submission.data());
+   }
+
+   void D3D12Queue::Signal(uint64_t value) {
+      ThrowIfFailed(commandQueue->Signal(fence.Get(), value));
+   }
+
+   uint64_t D3D12Queue::GetCompletedValue() const {
+      return fence->GetCompletedValue();
+   }
+
+   bool D3D12Queue::Wait(uint64_t value, std::chrono::milliseconds timeout) {
+      if (fence->GetCompletedValue() < value) {
+         ThrowIfFailed(fence->SetEventOnCompletion(value, fenceEvent.Get()));
+         // A registration left over from an earlier timed out wait can set the event early, so the
+         // fence itself decides the result.
+         std::ignore =
+             WaitForSingleObjectEx(fenceEvent.Get(), static_cast<DWORD>(timeout.count()), FALSE);
+      }
+      return fence->GetCompletedValue() >= value;
+   }
+
+   D3D12SwapChain::D3D12SwapChain(IDXGIFactory4* dxgiFactory,
+                                  ID3D12Device* d3dDevice,
+                                  ID3D12CommandQueue* commandQueue,
+                                  D3D12DescriptorAllocator& rtvAllocator,
+                                  const SwapChainDesc& desc) :
+       window(static_cast<HWND>(desc.window)), d3dDevice(d3dDevice), rtvAllocator(rtvAllocator),
+       bufferCount(desc.bufferCount) {
+
+      DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
+      swapChainDesc.Width = desc.width;
+      swapChainDesc.Height = desc.height;
+      swapChainDesc.Format = backBufferFormat;
+      swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+      swapChainDesc.BufferCount = bufferCount;
+      swapChainDesc.SampleDesc.Count = 1;
+      swapChainDesc.SampleDesc.Quality = 0;
+      swapChainDesc.Scaling = DXGI_SCALING_STRETCH;
+      swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+      swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_IGNORE;
+
+      DXGI_SWAP_CHAIN_FULLSCREEN_DESC fsSwapChainDesc = {};
+      fsSwapChainDesc.Windowed = TRUE;
+
+      ComPtr<IDXGISwapChain1> swapChain1;
+      ThrowIfFailed(dxgiFactory->CreateSwapChainForHwnd(commandQueue,
+                                                        window,
+                                                        &swapChainDesc,
+                                                        &fsSwapChainDesc,
+                                                        nullptr,
+                                                        swapChain1.GetAddressOf()));
+      ThrowIfFailed(swapChain1.As(&swapChain));
+      ThrowIfFailed(dxgiFactory->MakeWindowAssociation(window, DXGI_MWA_NO_ALT_ENTER));
+
+      CreateRenderTargets();
+   }
+
+   uint32_t D3D12SwapChain::GetBufferCount() const noexcept {
+      return bufferCount;
+   }
+
+   uint32_t D3D12SwapChain::GetCurrentBackBufferIndex() const {
+      return swapChain->GetCurrentBackBufferIndex();
+   }
+
+   Texture& D3D12SwapChain::GetBackBuffer(uint32_t index) {
+      return renderTargets[index];
+   }
+
+   std::chrono::nanoseconds D3D12SwapChain::GetRefreshInterval() const {
+      // The windowed swap chain does not know its refresh rate, so ask the display the window is
+      // currently mostly on.
+      MONITORINFOEXW monitorInfo = {};
+      monitorInfo.cbSize = sizeof(monitorInfo);
+      if (!GetMonitorInfoW(MonitorFromWindow(window, MONITOR_DEFAULTTONEAREST), &monitorInfo)) {
+         return std::chrono::nanoseconds{0};
+      }
+
+      DEVMODEW devMode = {};
+      devMode.dmSize = sizeof(devMode);
+      if (!EnumDisplaySettingsW(monitorInfo.szDevice, ENUM_CURRENT_SETTINGS, &devMode) ||
+          devMode.dmDisplayFrequency <= 1) {
+         // 0 and 1 both mean the hardware default rate.
+         return std::chrono::nanoseconds{0};
+      }
+      return std::chrono::nanoseconds{1'000'000'000 / devMode.dmDisplayFrequency};
+   }
+
+   PresentResult D3D12SwapChain::Present(uint32_t syncInterval) {
+      HRESULT hr = swapChain->Present(syncInterval, 0);
+
+      if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET) {
+         return PresentResult::DeviceLost;
+      }
+      ThrowIfFailed(hr);
+      if (hr != S_OK) {
+         TX_LOG_RATE_LIMITED(Info, Graphics, 1) << L"Present returned " << hr << std::endl;
+      }
+      return PresentResult::Ok;
+   }
+
+   PresentResult D3D12SwapChain::Resize(uint32_t width, uint32_t height) {
+      renderTargets.clear();
+
+      HRESULT hr = swapChain->ResizeBuffers(bufferCount, width, height, backBufferFormat, 0);
+      if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET) {
+         return PresentResult::DeviceLost;
+      }
+      ThrowIfFailed(hr);
+
+      CreateRenderTargets();
+      return PresentResult::Ok;
+   }
+
+   void D3D12SwapChain::CreateRenderTargets() {
+      renderTargets.reserve(bufferCount);
+
+      // Create rtvDescriptors
+      for (UINT n = 0; n < bufferCount; n++) {
+         ComPtr<ID3D12Resource> renderTarget;
+         ThrowIfFailed(swapChain->GetBuffer(n, IID_PPV_ARGS(renderTarget.GetAddressOf())));
+
+         wchar_t name[25] = {};
+         swprintf_s(name, L"Render Target %u", n);
+         renderTarget->SetName(name);
+
+         D3D12Descriptor rtvDescriptor = rtvAllocator.Allocate();
+         d3dDevice->CreateRenderTargetView(renderTarget.Get(), nullptr, rtvDescriptor.Get());
+
+         renderTargets.emplace_back(
+             std::move(renderTarget), ResourceState::Present, std::move(rtvDescriptor));
+      }
+   }
+
+   D3D12Device::D3D12Device() {
+      CreateDevice();
+   }
+
+   std::unique_ptr<CommandAllocator> D3D12Device::CreateCommandAllocator() {
+      return std::make_unique<D3D12CommandAllocator>(d3dDevice.Get());
+   }
+
+   std::unique_ptr<CommandList> D3D12Device::CreateCommandList() {
+      return std::make_unique<D3D12CommandList>(d3dDevice.Get(), enhancedBarriers);
+   }
+
+   std::unique_ptr<SwapChain> D3D12Device::CreateSwapChain(const SwapChainDesc& desc) {
+      return std::make_unique<D3D12SwapChain>(
+          dxgiFactory.Get(), d3dDevice.Get(), queue->Get(), *rtvAllocator, desc);
+   }
+
+   std::unique_ptr<Texture> D3D12Device::CreateDepthTarget(uint32_t width, uint32_t height) {
+      const CD3DX12_HEAP_PROPERTIES depthHeapProperties(D3D12_HEAP_TYPE_DEFAULT);
+
+      D3D12_RESOURCE_DESC depthStencilDesc =
+          CD3DX12_RESOURCE_DESC::Tex2D(depthBufferFormat, width, height, 1, 1);
+
+      depthStencilDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+      const CD3DX12_CLEAR_VALUE depthOptimizedClearValue(depthBufferFormat, 1.0f, 0u);
+
+      ComPtr<ID3D12Resource> depthStencil;
+      ThrowIfFailed(
+          d3dDevice->CreateCommittedResource(&depthHeapProperties,
+                                             D3D12_HEAP_FLAG_NONE,
+                                             &depthStencilDesc,
+                                             D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                                             &depthOptimizedClearValue,
+                                             IID_PPV_ARGS(depthStencil.GetAddressOf())));
+      depthStencil->SetName(L"Depth Stencil");
+
+      D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+      dsvDesc.Format = depthBufferFormat;
+      dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+
+      D3D12Descriptor dsvDescriptor = dsvAllocator->Allocate();
+      d3dDevice->CreateDepthStencilView(depthStencil.Get(), &dsvDesc, dsvDescriptor.Get());
+
+      return std::make_unique<D3D12Texture>(
+          std::move(depthStencil), ResourceState::DepthWrite, std::move(dsvDescriptor));
+   }
+
+   std::unique_ptr<UploadBuffer> D3D12Device::CreateUploadBuffer(uint64_t size) {
+      return std::make_unique<D3D12UploadBuffer>(d3dDevice.Get(), size);
+   }
+
+   AllocationInfo D3D12Device::GetAllocationInfo(const TextureDesc& desc) {
+      const D3D12_RESOURCE_DESC resourceDesc = ToResourceDesc(desc);
+      const D3D12_RESOURCE_ALLOCATION_INFO info =
+          d3dDevice->GetResourceAllocationInfo(0, 1, &resourceDesc);
+      return {info.SizeInBytes, info.Alignment};
+   }
+
+   std::unique_ptr<Heap> D3D12Device::CreateHeap(uint64_t size) {
+      return std::make_unique<D3D12Heap>(d3dDevice.Get(), size);
+   }
+
+   std::unique_ptr<Texture> D3D12Device::CreatePlacedTexture(Heap& heap,
+                                                             uint64_t offset,
+                                                             const TextureDesc& desc) {
+      const bool depth = desc.usage == TextureUsage::DepthStencil;
+      const DXGI_FORMAT format = ToDxgi(desc.format);
+
+      const D3D12_RESOURCE_DESC resourceDesc = ToResourceDesc(desc);
+      const CD3DX12_CLEAR_VALUE depthClearValue(format, 1.0f, 0u);
+      const ResourceState initialState =
+          depth ? ResourceState::DepthWrite : ResourceState::RenderTarget;
+
+      ComPtr<ID3D12Resource> resource;
+      ThrowIfFailed(d3dDevice->CreatePlacedResource(static_cast<D3D12Heap&>(heap).Get(),
+                                                    offset,
+                                                    &resourceDesc,
+                                                    ToD3D12(initialState),
+                                                    depth ? &depthClearValue : nullptr,
+                                                    IID_PPV_ARGS(resource.GetAddressOf())));
+      resource->SetName(L"Transient Texture");
+
+      D3D12Descriptor view = depth ? dsvAllocator->Allocate() : rtvAllocator->Allocate();
+      if (depth) {
+         D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+         dsvDesc.Format = format;
+         dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+         d3dDevice->CreateDepthStencilView(resource.Get(), &dsvDesc, view.Get());
+      } else {
+         d3dDevice->CreateRenderTargetView(resource.Get(), nullptr, view.Get());
+      }
+
+      return std::make_unique<D3D12Texture>(std::move(resource), initialState, std::move(view));
+   }
+
+   void D3D12Device::CreateDevice() {
+      DWORD dxgiFactoryFlags = 0;
+
+#if defined(_DEBUG)
+      {
+         ComPtr<ID3D12Debug> debugController;
+         if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(debugController.GetAddressOf())))) {
+            debugController->EnableDebugLayer();
+         }
+
+         ComPtr<IDXGIInfoQueue> dxgiInfoQueue;
+         if (SUCCEEDED(DXGIGetDebugInterface1(0, IID_PPV_ARGS(dxgiInfoQueue.GetAddressOf())))) {
+            dxgiFactoryFlags = DXGI_CREATE_FACTORY_DEBUG;
+
+            dxgiInfoQueue->SetBreakOnSeverity(
+                DXGI_DEBUG_ALL, DXGI_INFO_QUEUE_MESSAGE_SEVERITY_ERROR, true);
+            dxgiInfoQueue->SetBreakOnSeverity(
+                DXGI_DEBUG_ALL, DXGI_INFO_QUEUE_MESSAGE_SEVERITY_CORRUPTION, true);
+         }
+      }
+#endif // _DEBUG
+
+      ThrowIfFailed(
+          CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(dxgiFactory.ReleaseAndGetAddressOf())));
+
+      ComPtr<IDXGIAdapter1> adapter;
+      GetAdapter(adapter.GetAddressOf());
+
+      // Create the D3D Device Finally
+      ThrowIfFailed(D3D12CreateDevice(
+          adapter.Get(), featureLevel, IID_PPV_ARGS(d3dDevice.ReleaseAndGetAddressOf())));
+
+      // Set up some Device specific Debug things
+      // Guess NDEBUG differs from _DEBUG
+#ifndef NDEBUG
+      ComPtr<ID3D12InfoQueue> d3dInfoQueue;
+      if (SUCCEEDED(d3dDevice.As(&d3dInfoQueue))) {
+#ifdef _DEBUG
+         d3dInfoQueue->SetBreakOnSeverity(D3D12_MESSAGE_SEVERITY_CORRUPTION, true);
+         d3dInfoQueue->SetBreakOnSeverity(D3D12_MESSAGE_SEVERITY_ERROR, true);
+#endif
+         auto hide = std::array<D3D12_MESSAGE_ID, 4>{
+             D3D12_MESSAGE_ID_MAP_INVALID_NULLRANGE,
+             D3D12_MESSAGE_ID_UNMAP_INVALID_NULLRANGE,
+             // Workarounds for debug layer issues on hybrid-graphics systems
+             D3D12_MESSAGE_ID_EXECUTECOMMANDLISTS_WRONGSWAPCHAINBUFFERREFERENCE,
+             D3D12_MESSAGE_ID_RESOURCE_BARRIER_MISMATCHING_COMMAND_LIST_TYPE,
+         };
+         D3D12_INFO_QUEUE_FILTER filter = {};
+         filter.DenyList.NumIDs = static_cast<UINT>(std::size(hide));
+         filter.DenyList.pIDList = hide.data();
+         d3dInfoQueue->AddStorageFilterEntries(&filter);
+      }
+#endif
+
+      queue = std::make_unique<D3D12Queue>(d3dDevice.Get());
+
+      rtvAllocator = std::make_unique<D3D12DescriptorAllocator>(
+          d3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, descriptorPageSize);
+      dsvAllocator = std::make_unique<D3D12DescriptorAllocator>(
+          d3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, descriptorPageSize);
+
+#if D3D12_SDK_VERSION >= 608
+      CD3DX12FeatureSupport features;
+      enhancedBarriers = SUCCEEDED(features.Init(d3dDevice.Get())) &&
+                         features.EnhancedBarriersSupported();
+#endif
+      TX_LOG(Info, Graphics) << L"Using " << (enhancedBarriers ? L"enhanced" : L"legacy")
+                             << L" resource barriers" << std::endl;
+
+      // Check Shader Model 6 support
+      D3D12_FEATURE_DATA_SHADER_MODEL shaderModel = {D3D_SHADER_MODEL_6_0};
+      if (FAILED(d3dDevice->CheckFeatureSupport(
+              D3D12_FEATURE_SHADER_MODEL, &shaderModel, sizeof(shaderModel)))) {
+#ifdef _DEBUG
+         OutputDebugStringA("ERROR: Shader Model 6.0 is not supported!\n");
+#endif
+         throw std::runtime_error("Shader Model 6.0 is not supported!");
+      }
+   }
+
+   void D3D12Device::GetAdapter(IDXGIAdapter1** ppAdapter) {
+      *ppAdapter = nullptr;
+
+      ComPtr<IDXGIAdapter1> adapter;
+      for (UINT adapterIndex = 0;
+           DXGI_ERROR_NOT_FOUND !=
+           dxgiFactory->EnumAdapters1(adapterIndex, adapter.ReleaseAndGetAddressOf());
+           ++adapterIndex) {
+
+         DXGI_ADAPTER_DESC1 desc;
+
+         ThrowIfFailed(adapter->GetDesc1(&desc));
+
+         if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+            // naw.
+            continue;
+         }
+
+         if (SUCCEEDED(
+                 D3D12CreateDevice(adapter.Get(), featureLevel, __uuidof(ID3D12Device), nullptr))) {
+            break;
+         }
+      }
+
+#if !defined(NDEBUG) // Soo if DEBUG
+      if (!adapter) {
+         if (FAILED(dxgiFactory->EnumWarpAdapter(IID_PPV_ARGS(adapter.ReleaseAndGetAddressOf())))) {
+            throw std::runtime_error("WARP12 not available. Enable the 'Graphics Tools' optional "
+                                     "feature? whatever that means.");
+         }
+      }
+#endif
+      if (!adapter) {
+         throw std::runtime_error(
+             "No Direct3D 12 device found. You will not go to space today. :(");
+      }
+
+      *ppAdapter = adapter.Detach();
+   }
+}
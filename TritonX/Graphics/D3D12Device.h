@@ -0,0 +1,380 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "Graphics/BindlessSlotTable.h"
+#include "Graphics/DescriptorAllocator.h"
+#include "Graphics/DescriptorTableRing.h"
+#include "Graphics/Device.h"
+
+namespace TX::Graphics {
+
+   class D3D12DescriptorAllocator;
+
+   // A range of CPU descriptors, returned to the allocator it came from when destroyed.
+   class D3D12Descriptor {
+    public:
+      D3D12Descriptor() noexcept = default;
+      D3D12Descriptor(D3D12DescriptorAllocator* allocator,
+                      DescriptorRange range,
+                      D3D12_CPU_DESCRIPTOR_HANDLE handle) noexcept;
+      ~D3D12Descriptor();
+
+      D3D12Descriptor(D3D12Descriptor&& other) noexcept;
+      D3D12Descriptor& operator=(D3D12Descriptor&& other) noexcept;
+
+      [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE Get(uint32_t index = 0) const noexcept;
+
+      [[nodiscard]] uint32_t GetCount() const noexcept {
+         return range.count;
+      }
+
+    private:
+      D3D12DescriptorAllocator* allocator{nullptr};
+      DescriptorRange range;
+      D3D12_CPU_DESCRIPTOR_HANDLE handle{};
+   };
+
+   // Non shader visible descriptors of one heap type, in heaps of pageSize descriptors that are
+   // added as they fill up. Safe to use from any thread. Must outlive every descriptor it hands
+   // out.
+   class D3D12DescriptorAllocator {
+    public:
+      D3D12DescriptorAllocator(ID3D12Device* d3dDevice,
+                               D3D12_DESCRIPTOR_HEAP_TYPE type,
+                               uint32_t pageSize);
+
+      D3D12DescriptorAllocator(const D3D12DescriptorAllocator&) = delete;
+      D3D12DescriptorAllocator& operator=(const D3D12DescriptorAllocator&) = delete;
+
+      // count contiguous descriptors, so that they can be copied as one range.
+      [[nodiscard]] D3D12Descriptor Allocate(uint32_t count = 1);
+
+      [[nodiscard]] UINT GetDescriptorSize() const noexcept {
+         return descriptorSize;
+      }
+
+    private:
+      friend class D3D12Descriptor;
+
+      Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice;
+      D3D12_DESCRIPTOR_HEAP_TYPE type;
+      UINT descriptorSize;
+
+      // Indexed by page. Each entry is written once, before the allocator publishes its page.
+      std::array<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>, DescriptorAllocator::MaxPages>
+          heaps;
+      std::array<D3D12_CPU_DESCRIPTOR_HANDLE, DescriptorAllocator::MaxPages> heapStarts;
+
+      DescriptorAllocator allocator;
+   };
+
+   // Shader visible CBV, SRV and UAV descriptor tables for the frames in flight; see
+   // DescriptorTableRing. Bind GetHeap() on command lists that use the tables. The renderer does
+   // not create one yet; it is meant for the draw path, which does not exist so far.
+   //
+   // Owns its own shader visible heap, as D3D12BindlessTable does. A command list can only have
+   // one such heap bound, so a draw path uses one of the two, not both.
+   class D3D12DescriptorTableRing {
+    public:
+      D3D12DescriptorTableRing(ID3D12Device* d3dDevice,
+                               Timeline& timeline,
+                               uint32_t slotsPerFrame,
+                               uint32_t frameCount);
+
+      void BeginFrame() {
+         ring.BeginFrame();
+      }
+
+      void EndFrame(uint64_t fenceValue) noexcept {
+         ring.EndFrame(fenceValue);
+      }
+
+      // sources must stay valid until the next Flush, which fills the table in.
+      [[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE Stage(
+          std::span<const D3D12_CPU_DESCRIPTOR_HANDLE> sources);
+
+      // Copies every table staged since the last call with one CopyDescriptors. Call before
+      // submitting the command lists that use them.
+      void Flush();
+
+      [[nodiscard]] ID3D12DescriptorHeap* GetHeap() const noexcept {
+         return heap.Get();
+      }
+
+      [[nodiscard]] const DescriptorTableStats& GetStats() const noexcept {
+         return ring.GetStats();
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice;
+      Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> heap;
+      UINT descriptorSize;
+      D3D12_CPU_DESCRIPTOR_HANDLE cpuStart;
+      D3D12_GPU_DESCRIPTOR_HANDLE gpuStart;
+
+      DescriptorTableRing ring;
+
+      // Flush and Stage scratch, kept for its capacity.
+      std::vector<uint64_t> stagedSources;
+      std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> destStarts;
+      std::vector<UINT> destSizes;
+      std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> sourceStarts;
+      std::vector<UINT> sourceSizes;
+   };
+
+   // One shader visible CBV, SRV and UAV heap that views are written into once and then indexed
+   // by shaders through handle.index, so that draws need no descriptor tables of their own. The
+   // root signature declares the whole heap as one table of unbounded arrays, all starting at
+   // slot 0 and told apart by register space:
+   //
+   //    Texture2D textures[] : register(t0, space1);
+   //    ByteAddressBuffer buffers[] : register(t0, space2);
+   //    RWTexture2D<float4> rwTextures[] : register(u0, space3);
+   //    RWByteAddressBuffer rwBuffers[] : register(u0, space4);
+   //    cbuffer Indices : register(b0) { uint albedoIndex; ... }; // root constants
+   //
+   // The UAV arrays need resource binding tier 3 and are left out of the root signature below it.
+   // Call Collect once per frame to recycle the slots of removed views.
+   //
+   // The heap is this table's own, so it cannot be used alongside a D3D12DescriptorTableRing on
+   // the same command list; see there. The renderer creates neither yet.
+   class D3D12BindlessTable {
+    public:
+      static constexpr UINT TableParameter = 0;
+      static constexpr UINT ConstantsParameter = 1;
+      static constexpr UINT RootConstantCount = 16;
+
+      D3D12BindlessTable(ID3D12Device* d3dDevice, Timeline& timeline, uint32_t capacity);
+
+      BindlessHandle AddShaderResource(ID3D12Resource* resource,
+                                       const D3D12_SHADER_RESOURCE_VIEW_DESC* desc);
+      BindlessHandle AddUnorderedAccess(ID3D12Resource* resource,
+                                        const D3D12_UNORDERED_ACCESS_VIEW_DESC* desc);
+      // The slot is reused once the GPU has finished everything submitted so far.
+      void Remove(BindlessHandle handle);
+      void Collect();
+
+      // Sets the heap, the root signature and the table on a graphics command list.
+      void Bind(ID3D12GraphicsCommandList* commandList) const;
+
+      [[nodiscard]] ID3D12DescriptorHeap* GetHeap() const noexcept {
+         return heap.Get();
+      }
+
+      [[nodiscard]] ID3D12RootSignature* GetRootSignature() const noexcept {
+         return rootSignature.Get();
+      }
+
+      [[nodiscard]] const BindlessSlotTable& GetSlots() const noexcept {
+         return slots;
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice;
+      Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> heap;
+      Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature;
+      UINT descriptorSize;
+      D3D12_CPU_DESCRIPTOR_HANDLE cpuStart;
+      D3D12_GPU_DESCRIPTOR_HANDLE gpuStart;
+
+      BindlessSlotTable slots;
+
+      void CreateRootSignature(uint32_t capacity);
+   };
+
+   class D3D12Texture : public Texture {
+    public:
+      D3D12Texture(Microsoft::WRL::ComPtr<ID3D12Resource> resource,
+                   ResourceState initialState,
+                   D3D12Descriptor view);
+
+      [[nodiscard]] uint32_t GetWidth() const noexcept override;
+      [[nodiscard]] uint32_t GetHeight() const noexcept override;
+
+      [[nodiscard]] ID3D12Resource* GetResource() const noexcept {
+         return resource.Get();
+      }
+
+      // RTV or DSV, depending on how the texture is bound.
+      [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetView() const noexcept {
+         return view.Get();
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+      D3D12Descriptor view;
+   };
+
+   class D3D12UploadBuffer : public UploadBuffer {
+    public:
+      D3D12UploadBuffer(ID3D12Device* d3dDevice, uint64_t size);
+
+      [[nodiscard]] uint64_t GetSize() const noexcept override {
+         return size;
+      }
+
+      [[nodiscard]] std::byte* GetMappedData() const noexcept override {
+         return mappedData;
+      }
+
+      [[nodiscard]] uint64_t GetGpuAddress() const noexcept override {
+         return resource->GetGPUVirtualAddress();
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+      std::byte* mappedData;
+      uint64_t size;
+   };
+
+   class D3D12Heap : public Heap {
+    public:
+      D3D12Heap(ID3D12Device* d3dDevice, uint64_t size);
+
+      [[nodiscard]] uint64_t GetSize() const noexcept override {
+         return size;
+      }
+
+      [[nodiscard]] ID3D12Heap* Get() const noexcept {
+         return heap.Get();
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+      uint64_t size;
+   };
+
+   class D3D12CommandAllocator : public CommandAllocator {
+    public:
+      explicit D3D12CommandAllocator(ID3D12Device* d3dDevice);
+
+      void Reset() override;
+
+      [[nodiscard]] ID3D12CommandAllocator* Get() const noexcept {
+         return allocator.Get();
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+   };
+
+   // Records barriers as enhanced barriers with precise scopes when the device supports them,
+   // and as legacy transitions otherwise.
+   class D3D12CommandList : public CommandList {
+    public:
+      D3D12CommandList(ID3D12Device* d3dDevice, bool enhancedBarriers);
+
+      void Reset(CommandAllocator& allocator) override;
+      void Close() override;
+
+      void Barriers(std::span<const TextureBarrier> barriers) override;
+      void AliasingBarriers(std::span<const AliasingBarrier> barriers) override;
+      void SetRenderTarget(Texture& color, Texture* depth) override;
+      void ClearRenderTarget(Texture& color, const ClearColor& value) override;
+      void ClearDepth(Texture& depth, float value) override;
+      void SetViewport(uint32_t width, uint32_t height) override;
+
+      [[nodiscard]] ID3D12GraphicsCommandList* Get() const noexcept {
+         return commandList.Get();
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
+
+      std::vector<D3D12_RESOURCE_BARRIER> barrierBatch;
+
+#if D3D12_SDK_VERSION >= 608
+      // Only set when enhanced barriers are in use.
+      Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList7> commandList7;
+      std::vector<D3D12_TEXTURE_BARRIER> textureBarrierBatch;
+#endif
+   };
+
+   class D3D12Queue : public Queue {
+    public:
+      explicit D3D12Queue(ID3D12Device* d3dDevice);
+
+      void Execute(std::span<CommandList* const> commandLists) override;
+      void Signal(uint64_t value) override;
+      [[nodiscard]] uint64_t GetCompletedValue() const override;
+      bool Wait(uint64_t value, std::chrono::milliseconds timeout) override;
+
+      [[nodiscard]] ID3D12CommandQueue* Get() const noexcept {
+         return commandQueue.Get();
+      }
+
+    private:
+      Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue;
+
+      Microsoft::WRL::ComPtr<ID3D12Fence> fence;
+      Microsoft::WRL::Wrappers::Event fenceEvent;
+
+      std::vector<ID3D12CommandList*> submission;
+   };
+
+   class D3D12SwapChain : public SwapChain {
+    public:
+      D3D12SwapChain(IDXGIFactory4* dxgiFactory,
+                     ID3D12Device* d3dDevice,
+                     ID3D12CommandQueue* commandQueue,
+                     D3D12DescriptorAllocator& rtvAllocator,
+                     const SwapChainDesc& desc);
+
+      [[nodiscard]] uint32_t GetBufferCount() const noexcept override;
+      [[nodiscard]] uint32_t GetCurrentBackBufferIndex() const override;
+      [[nodiscard]] Texture& GetBackBuffer(uint32_t index) override;
+      [[nodiscard]] std::chrono::nanoseconds GetRefreshInterval() const override;
+
+      PresentResult Present(uint32_t syncInterval) override;
+      PresentResult Resize(uint32_t width, uint32_t height) override;
+
+    private:
+      HWND window;
+      Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice;
+      Microsoft::WRL::ComPtr<IDXGISwapChain3> swapChain;
+
+      D3D12DescriptorAllocator& rtvAllocator;
+
+      UINT bufferCount;
+      std::vector<D3D12Texture> renderTargets;
+
+      void CreateRenderTargets();
+   };
+
+   class D3D12Device : public Device {
+    public:
+      D3D12Device();
+
+      [[nodiscard]] Queue& GetQueue() noexcept override {
+         return *queue;
+      }
+
+      std::unique_ptr<CommandAllocator> CreateCommandAllocator() override;
+      std::unique_ptr<CommandList> CreateCommandList() override;
+      std::unique_ptr<SwapChain> CreateSwapChain(const SwapChainDesc& desc) override;
+      std::unique_ptr<Texture> CreateDepthTarget(uint32_t width, uint32_t height) override;
+      std::unique_ptr<UploadBuffer> CreateUploadBuffer(uint64_t size) override;
+
+      [[nodiscard]] AllocationInfo GetAllocationInfo(const TextureDesc& desc) override;
+      std::unique_ptr<Heap> CreateHeap(uint64_t size) override;
+      std::unique_ptr<Texture> CreatePlacedTexture(Heap& heap,
+                                                   uint64_t offset,
+                                                   const TextureDesc& desc) override;
+
+    private:
+      Microsoft::WRL::ComPtr<IDXGIFactory4> dxgiFactory;
+      Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice;
+
+      std::unique_ptr<D3D12Queue> queue;
+      std::unique_ptr<D3D12DescriptorAllocator> rtvAllocator;
+      std::unique_ptr<D3D12DescriptorAllocator> dsvAllocator;
+
+      D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
+      bool enhancedBarriers = false;
+
+      void CreateDevice();
+      void GetAdapter(IDXGIAdapter1** ppAdapter);
+   };
+}
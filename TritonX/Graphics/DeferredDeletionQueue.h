@@ -0,0 +1,95 @@
+//
+// DeferredDeletionQueue.h - Destroys objects once the GPU can no longer be reading them
+//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Graphics/Timeline.h"
+
+namespace TX::Graphics {
+
+   // Replaces draining the GPU before freeing something it may still reference. Released objects
+   // are tagged with a fence value and destroyed in batches by Collect once the timeline has passed
+   // it. Release may be called from any thread; Collect is meant for the thread that submits.
+   //
+   //    queue.Release(std::move(oldDepthTarget));
+   //    ...
+   //    queue.Collect(); // once per frame
+   class DeferredDeletionQueue {
+    public:
+      explicit DeferredDeletionQueue(Timeline& timeline) : timeline(timeline) {
+      }
+
+      // Whatever is still queued is destroyed immediately, so the GPU must be idle by then.
+      ~DeferredDeletionQueue() {
+         for (auto& entry : entries) {
+            entry.destroy(entry.object);
+         }
+      }
+
+      DeferredDeletionQueue(const DeferredDeletionQueue&) = delete;
+      DeferredDeletionQueue& operator=(const DeferredDeletionQueue&) = delete;
+
+      // Destroys object once the GPU has finished everything submitted before the timeline's next
+      // Signal, which covers all work that could have referenced it so far.
+      template <typename T>
+      void Release(std::unique_ptr<T> object) {
+         Release(std::move(object), timeline.GetNextValue());
+      }
+
+      // Destroys object once the timeline reaches fenceValue.
+      template <typename T>
+      void Release(std::unique_ptr<T> object, uint64_t fenceValue) {
+         if (!object) {
+            return;
+         }
+         std::lock_guard lock(mutex);
+         entries.push_back(Entry{.fenceValue = fenceValue,
+                                 .object = object.get(),
+                                 .destroy = [](void* p) { delete static_cast<T*>(p); }});
+         object.release();
+      }
+
+      // Destroys everything whose fence value the GPU has reached. Entries are checked in release
+      // order, so one released with a later value holds back those behind it until it completes.
+      void Collect() {
+         const uint64_t completedValue = timeline.GetCompletedValue();
+         {
+            std::lock_guard lock(mutex);
+            while (!entries.empty() && entries.front().fenceValue <= completedValue) {
+               batch.push_back(entries.front());
+               entries.pop_front();
+            }
+         }
+         // Destructors run outside the lock so releases from other threads never wait on them.
+         for (auto& entry : batch) {
+            entry.destroy(entry.object);
+         }
+         batch.clear();
+      }
+
+      [[nodiscard]] size_t GetPendingCount() const {
+         std::lock_guard lock(mutex);
+         return entries.size();
+      }
+
+    private:
+      struct Entry {
+         uint64_t fenceValue;
+         void* object;
+         void (*destroy)(void*);
+      };
+
+      Timeline& timeline;
+
+      mutable std::mutex mutex;
+      std::deque<Entry> entries;
+      std::vector<Entry> batch;
+   };
+}
@@ -0,0 +1,231 @@
+//
+// DescriptorAllocator.h - Paged slot allocator backing the CPU descriptor heaps
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace TX::Graphics {
+
+   // count slots starting at first within one page.
+   struct DescriptorRange {
+      static constexpr uint32_t NoPage = UINT32_MAX;
+
+      uint32_t page{NoPage};
+      uint32_t first{0};
+      uint32_t count{0};
+
+      [[nodiscard]] bool IsValid() const noexcept {
+         return page != NoPage;
+      }
+   };
+
+   // Hands out ranges of slots from fixed size pages and leaves what a slot means to the caller,
+   // which for D3D12 is a descriptor in a heap per page. A page is added, through createPage,
+   // only once every existing page is too full for a request. Pages are never released.
+   //
+   // Each page keeps a bitmap of its slots behind its own lock, so threads allocating at the same
+   // time only contend if they land on the same page. Threads start looking at different pages,
+   // and skip pages another thread holds before waiting on any. Finding a free slot scans the
+   // page's bitmap a word at a time; with pages of a few hundred slots that is a handful of
+   // words, independent of how many slots are in use overall.
+   class DescriptorAllocator {
+    public:
+      static constexpr uint32_t MaxPages = 256;
+
+      // Called with the index of a new page before any of its slots are handed out. May throw,
+      // in which case the page is not added.
+      using CreatePageFunction = std::function<void(uint32_t page)>;
+
+      DescriptorAllocator(uint32_t pageSize, CreatePageFunction createPage) :
+          pageSize(pageSize), createPage(std::move(createPage)) {
+         if (pageSize == 0) {
+            throw std::invalid_argument("DescriptorAllocator pages must hold at least one slot");
+         }
+      }
+
+      DescriptorAllocator(const DescriptorAllocator&) = delete;
+      DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+      // Allocates count contiguous slots. Throws std::invalid_argument if count does not fit in
+      // a page and std::length_error once MaxPages are full.
+      DescriptorRange Allocate(uint32_t count = 1) {
+         if (count == 0 || count > pageSize) {
+            throw std::invalid_argument("DescriptorAllocator range must fit within one page");
+         }
+         while (true) {
+            const uint32_t pagesNow = pageCount.load(std::memory_order_acquire);
+            DescriptorRange range;
+            if (pagesNow > 0 && (TryPages(count, pagesNow, false, range) ||
+                                 TryPages(count, pagesNow, true, range))) {
+               return range;
+            }
+            AddPage(pagesNow);
+         }
+      }
+
+      // Returns range's slots. Throws std::logic_error if any of them are not allocated.
+      void Free(const DescriptorRange& range) {
+         if (!range.IsValid()) {
+            return;
+         }
+         Page& page = *pages[range.page].load(std::memory_order_acquire);
+         std::lock_guard lock(page.mutex);
+         if (!page.IsSet(range.first, range.count, true)) {
+            throw std::logic_error("DescriptorAllocator range freed that was not allocated");
+         }
+         page.Set(range.first, range.count, false);
+         page.freeCount.fetch_add(range.count, std::memory_order_relaxed);
+      }
+
+      [[nodiscard]] uint32_t GetPageSize() const noexcept {
+         return pageSize;
+      }
+
+      [[nodiscard]] uint32_t GetPageCount() const noexcept {
+         return pageCount.load(std::memory_order_acquire);
+      }
+
+      // Slots in use across all pages. Only exact while no other thread allocates or frees.
+      [[nodiscard]] uint64_t GetAllocatedCount() const noexcept {
+         const uint32_t pagesNow = GetPageCount();
+         uint64_t allocated = uint64_t{pagesNow} * pageSize;
+         for (uint32_t p = 0; p < pagesNow; p++) {
+            allocated -= pages[p].load(std::memory_order_acquire)->freeCount.load(
+                std::memory_order_relaxed);
+         }
+         return allocated;
+      }
+
+    private:
+      struct Page {
+         explicit Page(uint32_t size) : used((size + 63) / 64, 0), size(size), freeCount(size) {
+         }
+
+         std::mutex mutex;
+         std::vector<uint64_t> used;
+         uint32_t size;
+         // Read without the lock to skip pages that cannot fit a request.
+         std::atomic<uint32_t> freeCount;
+
+         // First slot of count free ones in a row, or size if there are none.
+         [[nodiscard]] uint32_t FindFree(uint32_t count) const noexcept {
+            uint32_t runStart = 0;
+            uint32_t runLength = 0;
+            uint32_t slot = 0;
+            while (slot < size) {
+               const uint64_t word = used[slot / 64] >> (slot % 64);
+               const uint32_t slotsInWord = 64 - slot % 64;
+               // Free slots from here up to the next used one, the end of the word or the page.
+               const uint32_t freeSlots = std::min(
+                   word == 0 ? slotsInWord : static_cast<uint32_t>(std::countr_zero(word)),
+                   size - slot);
+               if (runLength == 0) {
+                  runStart = slot;
+               }
+               runLength += freeSlots;
+               if (runLength >= count) {
+                  return runStart;
+               }
+               slot += freeSlots;
+               if (freeSlots < slotsInWord && slot < size) {
+                  // Stopped at a used slot, so the run starts over after the used ones.
+                  slot += static_cast<uint32_t>(
+                      std::countr_one(used[slot / 64] >> (slot % 64)));
+                  runLength = 0;
+               }
+            }
+            return size;
+         }
+
+         [[nodiscard]] bool IsSet(uint32_t first, uint32_t count, bool value) const noexcept {
+            for (uint32_t slot = first; slot < first + count; slot++) {
+               if (((used[slot / 64] >> (slot % 64)) & 1) != static_cast<uint64_t>(value)) {
+                  return false;
+               }
+            }
+            return true;
+         }
+
+         void Set(uint32_t first, uint32_t count, bool value) noexcept {
+            for (uint32_t slot = first; slot < first + count;) {
+               const uint32_t bit = slot % 64;
+               const uint32_t bits = std::min(64 - bit, first + count - slot);
+               const uint64_t mask = (bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1) << bit;
+               if (value) {
+                  used[slot / 64] |= mask;
+               } else {
+                  used[slot / 64] &= ~mask;
+               }
+               slot += bits;
+            }
+         }
+      };
+
+      uint32_t pageSize;
+      CreatePageFunction createPage;
+
+      // Published by AddPage, in order, and never removed.
+      std::array<std::atomic<Page*>, MaxPages> pages{};
+      std::atomic<uint32_t> pageCount{0};
+
+      std::mutex addPageMutex;
+      std::vector<std::unique_ptr<Page>> ownedPages;
+
+      // Looks through the first pageLimit pages, starting at one that depends on the calling
+      // thread. Without wait, pages another thread holds are skipped.
+      bool TryPages(uint32_t count, uint32_t pageLimit, bool wait, DescriptorRange& range) {
+         const auto start = static_cast<uint32_t>(
+             std::hash<std::thread::id>{}(std::this_thread::get_id()) % pageLimit);
+         for (uint32_t i = 0; i < pageLimit; i++) {
+            const uint32_t p = (start + i) % pageLimit;
+            Page& page = *pages[p].load(std::memory_order_acquire);
+            if (page.freeCount.load(std::memory_order_relaxed) < count) {
+               continue;
+            }
+            std::unique_lock lock(page.mutex, std::defer_lock);
+            if (wait) {
+               lock.lock();
+            } else if (!lock.try_lock()) {
+               continue;
+            }
+            const uint32_t first = page.FindFree(count);
+            if (first != page.size) {
+               page.Set(first, count, true);
+               page.freeCount.fetch_sub(count, std::memory_order_relaxed);
+               range = {p, first, count};
+               return true;
+            }
+         }
+         return false;
+      }
+
+      // Adds a page, unless another thread has since pagesSeen were looked through.
+      void AddPage(uint32_t pagesSeen) {
+         std::lock_guard lock(addPageMutex);
+         const uint32_t index = pageCount.load(std::memory_order_relaxed);
+         if (index != pagesSeen) {
+            return;
+         }
+         if (index == MaxPages) {
+            throw std::length_error("DescriptorAllocator out of pages");
+         }
+         auto page = std::make_unique<Page>(pageSize);
+         createPage(index);
+         pages[index].store(page.get(), std::memory_order_release);
+         ownedPages.push_back(std::move(page));
+         pageCount.store(index + 1, std::memory_order_release);
+      }
+   };
+}
@@ -0,0 +1,170 @@
+//
+// DescriptorTableRing.h - Per frame descriptor table slots, staged for batched copies and deduped
+//
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Graphics/Timeline.h"
+
+namespace TX::Graphics {
+
+   // A table staged since the last TakeCopies, to be filled from sources.
+   struct DescriptorTableCopy {
+      uint32_t firstSlot;
+      uint32_t firstSource;
+      uint32_t count;
+   };
+
+   struct DescriptorTableStats {
+      uint64_t tables;
+      uint64_t cacheHits;
+      uint64_t descriptorsCopied;
+   };
+
+   // Slot bookkeeping for a shader visible descriptor heap that is refilled every frame. The heap
+   // is split into a partition per frame that is reclaimed by fence value, as in UploadRing.
+   // Sources are backend CPU descriptor handles, kept as integers.
+   //
+   // Stage does not copy anything. It reserves a table's slots and queues the copy, and the
+   // backend takes every queued copy at once before the frame is submitted. A table with the same
+   // sources as one staged recently in the same frame gets that table's slots back instead, with
+   // nothing queued. The lookup is a two way set associative cache on a hash of the sources, so
+   // it costs one hash and at most two comparisons. A table evicted by more recently used ones in
+   // its set is simply staged again. Sources are compared by handle, not by what they describe,
+   // so a CPU descriptor rewritten during a frame must not be staged again in that frame.
+   //
+   // Not thread safe; meant for the thread that records the frame.
+   class DescriptorTableRing {
+    public:
+      static constexpr uint32_t DefaultCacheSize = 1024;
+
+      // cacheSize, in tables, is rounded up to a power of two.
+      DescriptorTableRing(Timeline& timeline,
+                          uint32_t slotsPerFrame,
+                          uint32_t frameCount,
+                          uint32_t cacheSize = DefaultCacheSize) :
+          timeline(timeline), slotsPerFrame(slotsPerFrame), partitionFences(frameCount, 0),
+          partition(frameCount - 1), head(0), frame(1), stats{} {
+         if (frameCount == 0 || slotsPerFrame == 0) {
+            throw std::invalid_argument("DescriptorTableRing needs at least one slot per frame");
+         }
+         cache.resize(std::bit_ceil(std::max(cacheSize, 2u)));
+      }
+
+      // Moves on to the next partition, waiting for the GPU to finish the frame that last used
+      // it. Copies still queued are dropped.
+      void BeginFrame() {
+         partition = (partition + 1) % static_cast<uint32_t>(partitionFences.size());
+         timeline.Wait(partitionFences[partition]);
+         head = 0;
+         frame++;
+         frameSources.clear();
+         copies.clear();
+      }
+
+      // fenceValue is signalled once the GPU is done with every table staged this frame.
+      void EndFrame(uint64_t fenceValue) noexcept {
+         partitionFences[partition] = fenceValue;
+      }
+
+      // Returns the heap slot the table holding sources, in order, starts at. Throws
+      // std::length_error if the frame's partition is full.
+      uint32_t Stage(std::span<const uint64_t> sources) {
+         const auto count = static_cast<uint32_t>(sources.size());
+         const uint64_t hash = Hash(sources);
+         // Each set keeps its most recently used table first.
+         CacheEntry* set = &cache[(hash & (cache.size() / 2 - 1)) * 2];
+         for (uint32_t way = 0; way < 2; way++) {
+            const CacheEntry& entry = set[way];
+            if (entry.frame == frame && entry.hash == hash && entry.count == count &&
+                std::equal(sources.begin(),
+                           sources.end(),
+                           frameSources.begin() + entry.firstSource)) {
+               std::swap(set[0], set[way]);
+               stats.cacheHits++;
+               return set[0].firstSlot;
+            }
+         }
+
+         if (count > slotsPerFrame - head) {
+            throw std::length_error("DescriptorTableRing frame partition exhausted");
+         }
+         const uint32_t firstSlot = partition * slotsPerFrame + head;
+         const auto firstSource = static_cast<uint32_t>(frameSources.size());
+         head += count;
+         frameSources.insert(frameSources.end(), sources.begin(), sources.end());
+         copies.push_back({firstSlot, firstSource, count});
+         set[1] = set[0];
+         set[0] = {hash, frame, firstSlot, firstSource, count};
+
+         stats.tables++;
+         stats.descriptorsCopied += count;
+         return firstSlot;
+      }
+
+      // The copies staged since the last call, and the sources they index into. Both stay valid
+      // until the next Stage or BeginFrame.
+      [[nodiscard]] std::span<const DescriptorTableCopy> TakeCopies() noexcept {
+         taken.swap(copies);
+         copies.clear();
+         return taken;
+      }
+
+      [[nodiscard]] std::span<const uint64_t> GetSources() const noexcept {
+         return frameSources;
+      }
+
+      [[nodiscard]] uint32_t GetSlotCount() const noexcept {
+         return slotsPerFrame * static_cast<uint32_t>(partitionFences.size());
+      }
+
+      [[nodiscard]] const DescriptorTableStats& GetStats() const noexcept {
+         return stats;
+      }
+
+    private:
+      struct CacheEntry {
+         uint64_t hash;
+         // Entries from earlier frames point at slots that may since have been reused.
+         uint64_t frame;
+         uint32_t firstSlot;
+         uint32_t firstSource;
+         uint32_t count;
+      };
+
+      Timeline& timeline;
+      uint32_t slotsPerFrame;
+
+      std::vector<uint64_t> partitionFences;
+      uint32_t partition;
+      uint32_t head;
+      // Starts at 1 so that the zeroed cache entries never match.
+      uint64_t frame;
+
+      std::vector<CacheEntry> cache;
+      // Sources of every table staged this frame, which cache hits are verified against.
+      std::vector<uint64_t> frameSources;
+      std::vector<DescriptorTableCopy> copies;
+      std::vector<DescriptorTableCopy> taken;
+      DescriptorTableStats stats;
+
+      static uint64_t Hash(std::span<const uint64_t> sources) noexcept {
+         uint64_t hash = 0x9e3779b97f4a7c15ull ^ sources.size();
+         for (const uint64_t source : sources) {
+            // splitmix64 finalizer over the running value.
+            hash ^= source + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+            hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+            hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+            hash ^= hash >> 31;
+         }
+         return hash;
+      }
+   };
+}
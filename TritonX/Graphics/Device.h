@@ -0,0 +1,212 @@
+//
+// Device.h - API neutral device, queue and swap chain interfaces the frame loop renders through
+//
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace TX::Graphics {
+
+   // Subset of resource states the renderer transitions between. Backends map these onto their
+   // native equivalents.
+   enum class ResourceState {
+      Common,
+      Present,
+      RenderTarget,
+      DepthWrite,
+      DepthRead,
+      ShaderResource,
+      UnorderedAccess,
+      CopySource,
+      CopyDest,
+   };
+
+   using ClearColor = std::array<float, 4>;
+
+   class Texture {
+    public:
+      virtual ~Texture() = default;
+
+      [[nodiscard]] virtual uint32_t GetWidth() const noexcept = 0;
+      [[nodiscard]] virtual uint32_t GetHeight() const noexcept = 0;
+
+      // The state the texture is left in once everything submitted so far has executed. Kept up
+      // to date by CommandRecorder on the submitting thread; see ResourceStateTracker.
+      [[nodiscard]] ResourceState GetCommittedState() const noexcept {
+         return committedState;
+      }
+
+      void SetCommittedState(ResourceState state) noexcept {
+         committedState = state;
+      }
+
+    protected:
+      explicit Texture(ResourceState initialState) noexcept : committedState(initialState) {
+      }
+
+    private:
+      ResourceState committedState;
+   };
+
+   struct TextureBarrier {
+      Texture* texture;
+      ResourceState before;
+      ResourceState after;
+   };
+
+   // after is about to be used in memory that before, or any resource if null, used last.
+   struct AliasingBarrier {
+      Texture* before;
+      Texture* after;
+   };
+
+   enum class TextureFormat {
+      Bgra8Unorm,
+      Rgba16Float,
+      D32Float,
+   };
+
+   // Textures created for rendering into start out in RenderTarget or DepthWrite respectively.
+   enum class TextureUsage {
+      RenderTarget,
+      DepthStencil,
+   };
+
+   struct TextureDesc {
+      uint32_t width;
+      uint32_t height;
+      TextureFormat format;
+      TextureUsage usage;
+
+      constexpr bool operator==(const TextureDesc&) const noexcept = default;
+   };
+
+   struct AllocationInfo {
+      uint64_t size;
+      uint64_t alignment;
+   };
+
+   // GPU memory that textures are placed into. Holds render target and depth stencil textures
+   // only, and must outlive the textures placed in it.
+   class Heap {
+    public:
+      virtual ~Heap() = default;
+
+      [[nodiscard]] virtual uint64_t GetSize() const noexcept = 0;
+   };
+
+   // CPU written memory the GPU reads from directly, mapped for the buffer's whole lifetime. The
+   // mapping is typically write combined, so it should be written sequentially and never read.
+   class UploadBuffer {
+    public:
+      virtual ~UploadBuffer() = default;
+
+      [[nodiscard]] virtual uint64_t GetSize() const noexcept = 0;
+      [[nodiscard]] virtual std::byte* GetMappedData() const noexcept = 0;
+      [[nodiscard]] virtual uint64_t GetGpuAddress() const noexcept = 0;
+   };
+
+   // Backing memory for recorded commands. Must not be reset while the GPU may still be executing
+   // a command list recorded into it.
+   class CommandAllocator {
+    public:
+      virtual ~CommandAllocator() = default;
+
+      virtual void Reset() = 0;
+   };
+
+   class CommandList {
+    public:
+      virtual ~CommandList() = default;
+
+      virtual void Reset(CommandAllocator& allocator) = 0;
+      virtual void Close() = 0;
+
+      // Records all of barriers as one batch.
+      virtual void Barriers(std::span<const TextureBarrier> barriers) = 0;
+      // The contents of an aliased texture are undefined afterwards, so the first thing done with
+      // it must clear or entirely overwrite it.
+      virtual void AliasingBarriers(std::span<const AliasingBarrier> barriers) = 0;
+
+      void Transition(Texture& texture, ResourceState before, ResourceState after) {
+         const TextureBarrier barrier{&texture, before, after};
+         Barriers({&barrier, 1});
+      }
+      virtual void SetRenderTarget(Texture& color, Texture* depth) = 0;
+      virtual void ClearRenderTarget(Texture& color, const ClearColor& value) = 0;
+      virtual void ClearDepth(Texture& depth, float value) = 0;
+      virtual void SetViewport(uint32_t width, uint32_t height) = 0;
+   };
+
+   // A GPU queue together with the fence that tracks its progress. Values passed to Signal must
+   // increase monotonically. Wait is for a single waiting thread at a time; see Timeline for
+   // anything more.
+   class Queue {
+    public:
+      virtual ~Queue() = default;
+
+      virtual void Execute(std::span<CommandList* const> commandLists) = 0;
+      virtual void Signal(uint64_t value) = 0;
+      [[nodiscard]] virtual uint64_t GetCompletedValue() const = 0;
+      // Blocks the calling thread until the fence reaches value or timeout passes. Returns whether
+      // value was reached.
+      virtual bool Wait(uint64_t value, std::chrono::milliseconds timeout) = 0;
+   };
+
+   enum class PresentResult {
+      Ok,
+      DeviceLost,
+   };
+
+   struct SwapChainDesc {
+      void* window; // HWND on Windows, ignored by backends that do not present.
+      uint32_t width;
+      uint32_t height;
+      uint32_t bufferCount;
+   };
+
+   class SwapChain {
+    public:
+      virtual ~SwapChain() = default;
+
+      [[nodiscard]] virtual uint32_t GetBufferCount() const noexcept = 0;
+      [[nodiscard]] virtual uint32_t GetCurrentBackBufferIndex() const = 0;
+      [[nodiscard]] virtual Texture& GetBackBuffer(uint32_t index) = 0;
+
+      // Period of the display the swap chain presents to, or zero if it cannot be determined. May
+      // change after Resize, since the window may have moved to another display.
+      [[nodiscard]] virtual std::chrono::nanoseconds GetRefreshInterval() const = 0;
+
+      // syncInterval 0 presents immediately, n waits for the nth vertical blank.
+      virtual PresentResult Present(uint32_t syncInterval) = 0;
+      // All back buffer references must have been released by the GPU before resizing.
+      virtual PresentResult Resize(uint32_t width, uint32_t height) = 0;
+   };
+
+   class Device {
+    public:
+      virtual ~Device() = default;
+
+      [[nodiscard]] virtual Queue& GetQueue() noexcept = 0;
+
+      virtual std::unique_ptr<CommandAllocator> CreateCommandAllocator() = 0;
+      virtual std::unique_ptr<CommandList> CreateCommandList() = 0;
+      virtual std::unique_ptr<SwapChain> CreateSwapChain(const SwapChainDesc& desc) = 0;
+      virtual std::unique_ptr<Texture> CreateDepthTarget(uint32_t width, uint32_t height) = 0;
+      virtual std::unique_ptr<UploadBuffer> CreateUploadBuffer(uint64_t size) = 0;
+
+      [[nodiscard]] virtual AllocationInfo GetAllocationInfo(const TextureDesc& desc) = 0;
+      virtual std::unique_ptr<Heap> CreateHeap(uint64_t size) = 0;
+      // offset must be a multiple of the alignment GetAllocationInfo reports for desc. Textures
+      // placed in overlapping memory alias each other; see CommandList::AliasingBarriers.
+      virtual std::unique_ptr<Texture> CreatePlacedTexture(Heap& heap,
+                                                           uint64_t offset,
+                                                           const TextureDesc& desc) = 0;
+   };
+}
@@ -0,0 +1,179 @@
+//
+// FrameTiming.h - Splits each frame into CPU work, GPU fence stalls and present stalls
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "TripleBuffer.h"
+
+namespace TX::Graphics {
+
+   // What is holding the frame rate back over the recent window.
+   enum class FrameBound {
+      Unknown,
+      Cpu,
+      Gpu,
+      VSync,
+   };
+
+   constexpr const wchar_t* ToString(FrameBound bound) noexcept {
+      switch (bound) {
+         case FrameBound::Cpu:
+            return L"CPU";
+         case FrameBound::Gpu:
+            return L"GPU";
+         case FrameBound::VSync:
+            return L"VSync";
+         default:
+            return L"Unknown";
+      }
+   }
+
+   // One frame, in clock counts. cpu is whatever part of the frame was not spent blocked in
+   // either wait, so the three always add up to the frame time.
+   struct FrameTimingSample {
+      uint64_t frame;
+      uint64_t fenceWait;
+      uint64_t presentWait;
+   };
+
+   // Means over the window, in milliseconds.
+   struct FrameTimingSnapshot {
+      uint64_t sequence;
+      uint32_t frameCount;
+      double frameMs;
+      double cpuMs;
+      double fenceWaitMs;
+      double presentWaitMs;
+      FrameBound bound;
+   };
+
+   // Keeps running totals over the last WindowFrames frames and classifies them. Frames that are
+   // not blocked for a meaningful share of their time are limited by the CPU. Blocked frames are
+   // waiting on the GPU or on the display, and which one cannot be told from where they block: a
+   // swap chain waiting for the display to release a back buffer stalls the queue, so a VSync
+   // limited frame usually shows up as a fence wait rather than inside Present. Blocked frames
+   // that keep up with the display's refresh interval are therefore VSync bound and slower ones
+   // GPU bound. Without a refresh interval the larger wait decides.
+   //
+   // Each Record publishes a new snapshot for one reader thread through a TripleBuffer. Recording
+   // must happen on a single thread (the one rendering).
+   class FrameTiming {
+    public:
+      static constexpr uint32_t WindowFrames = 120;
+      // Share of the frame a wait must take before it is considered the limiting factor. Below
+      // this, waits are scheduling noise and the CPU is what keeps the frame from finishing sooner.
+      static constexpr double StallShare = 0.1;
+      // How far above the refresh interval the mean frame may be and still count as keeping up.
+      static constexpr double RefreshTolerance = 0.05;
+
+      explicit FrameTiming(uint64_t frequency) noexcept : frequency(frequency) {
+      }
+
+      void Record(const FrameTimingSample& sample) noexcept {
+         auto& slot = samples[next];
+         if (count == WindowFrames) {
+            totals.frame -= slot.frame;
+            totals.fenceWait -= slot.fenceWait;
+            totals.presentWait -= slot.presentWait;
+         } else {
+            count++;
+         }
+
+         // Waits are measured inside the frame, but clamp anyway so cpu can never underflow.
+         slot.frame = sample.frame;
+         slot.fenceWait = sample.fenceWait < sample.frame ? sample.fenceWait : sample.frame;
+         slot.presentWait =
+             sample.presentWait < sample.frame - slot.fenceWait ? sample.presentWait
+                                                                : sample.frame - slot.fenceWait;
+         totals.frame += slot.frame;
+         totals.fenceWait += slot.fenceWait;
+         totals.presentWait += slot.presentWait;
+         next = (next + 1) % WindowFrames;
+
+         Publish();
+      }
+
+      // In clock counts, zero if unknown.
+      void SetRefreshInterval(uint64_t interval) noexcept {
+         refreshInterval = interval;
+      }
+
+      void Reset() noexcept {
+         samples = {};
+         totals = {};
+         count = 0;
+         next = 0;
+      }
+
+      // All arguments in clock counts. frame is the mean frame time, the waits the mean time
+      // blocked per frame.
+      static constexpr FrameBound Classify(uint64_t frame,
+                                           uint64_t fenceWait,
+                                           uint64_t presentWait,
+                                           uint64_t refreshInterval) noexcept {
+         if (frame == 0) {
+            return FrameBound::Unknown;
+         }
+         const double fenceShare = static_cast<double>(fenceWait) / static_cast<double>(frame);
+         const double presentShare = static_cast<double>(presentWait) / static_cast<double>(frame);
+         if (fenceShare < StallShare && presentShare < StallShare) {
+            return FrameBound::Cpu;
+         }
+         if (refreshInterval == 0) {
+            return fenceShare >= presentShare ? FrameBound::Gpu : FrameBound::VSync;
+         }
+         const double limit = static_cast<double>(refreshInterval) * (1.0 + RefreshTolerance);
+         return static_cast<double>(frame) <= limit ? FrameBound::VSync : FrameBound::Gpu;
+      }
+
+      // Writer side: the current window, for the recording thread itself.
+      [[nodiscard]] FrameTimingSnapshot Summarize() const noexcept {
+         return FrameTimingSnapshot{
+             .sequence = sequence,
+             .frameCount = count,
+             .frameMs = MeanMs(totals.frame),
+             .cpuMs = MeanMs(totals.frame - totals.fenceWait - totals.presentWait),
+             .fenceWaitMs = MeanMs(totals.fenceWait),
+             .presentWaitMs = MeanMs(totals.presentWait),
+             .bound = count == 0 ? FrameBound::Unknown
+                                 : Classify(totals.frame / count,
+                                            totals.fenceWait / count,
+                                            totals.presentWait / count,
+                                            refreshInterval)};
+      }
+
+      // Reader side, safe to call from one other thread without locking.
+      const FrameTimingSnapshot& ReadSnapshot() noexcept {
+         return snapshots.Read();
+      }
+
+    private:
+      std::array<FrameTimingSample, WindowFrames> samples{};
+      FrameTimingSample totals{};
+      uint32_t count{0};
+      uint32_t next{0};
+      uint64_t frequency;
+      uint64_t refreshInterval{0};
+      uint64_t sequence{0};
+
+      TripleBuffer<FrameTimingSnapshot> snapshots;
+
+      double MeanMs(uint64_t total) const noexcept {
+         if (count == 0) {
+            return 0.0;
+         }
+         return static_cast<double>(total) * 1000.0 /
+                (static_cast<double>(frequency) * static_cast<double>(count));
+      }
+
+      void Publish() noexcept {
+         ++sequence;
+         snapshots.Back() = Summarize();
+         snapshots.Publish();
+      }
+   };
+}
@@ -0,0 +1,498 @@
+//
+// NullDevice.h - Headless backend that records calls and simulates GPU timing without a GPU
+//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Graphics/Device.h"
+
+namespace TX::Graphics {
+
+   struct NullDeviceDesc {
+      // Simulated GPU execution time of each recorded command.
+      std::chrono::nanoseconds commandCost{0};
+      // Vertical blank period that presents with a non zero sync interval are aligned to.
+      std::chrono::nanoseconds refreshInterval{16'666'667};
+      // Presents that may be queued ahead of the display before Present blocks, as in DXGI.
+      uint32_t maxFrameLatency{3};
+   };
+
+   // Totals of the calls made against a NullDevice since it was created.
+   struct NullDeviceCounters {
+      uint64_t executes;
+      uint64_t commandLists;
+      uint64_t commands;
+      // Individual transitions, and the Barriers calls they were recorded in.
+      uint64_t barriers;
+      uint64_t barrierBatches;
+      uint64_t aliasingBarriers;
+      uint64_t signals;
+      uint64_t waits;
+      uint64_t presents;
+      uint64_t resizes;
+   };
+
+   struct NullCommand {
+      enum class Op {
+         Transition,
+         Aliasing,
+         SetRenderTarget,
+         ClearRenderTarget,
+         ClearDepth,
+         SetViewport,
+      };
+
+      Op op;
+      Texture* target;
+      ResourceState before;
+      ResourceState after;
+   };
+
+   class NullTexture : public Texture {
+    public:
+      NullTexture(uint32_t width, uint32_t height, ResourceState initialState) :
+          Texture(initialState), width(width), height(height) {
+      }
+
+      [[nodiscard]] uint32_t GetWidth() const noexcept override {
+         return width;
+      }
+
+      [[nodiscard]] uint32_t GetHeight() const noexcept override {
+         return height;
+      }
+
+      void Resize(uint32_t newWidth, uint32_t newHeight) noexcept {
+         width = newWidth;
+         height = newHeight;
+      }
+
+    private:
+      uint32_t width;
+      uint32_t height;
+   };
+
+   class NullHeap : public Heap {
+    public:
+      explicit NullHeap(uint64_t size) noexcept : size(size) {
+      }
+
+      [[nodiscard]] uint64_t GetSize() const noexcept override {
+         return size;
+      }
+
+    private:
+      uint64_t size;
+   };
+
+   // Plain host memory, at a made up GPU address.
+   class NullUploadBuffer : public UploadBuffer {
+    public:
+      static constexpr uint64_t GpuAddress = uint64_t{1} << 40;
+
+      explicit NullUploadBuffer(uint64_t size) :
+          data(std::make_unique<std::byte[]>(size)), size(size) {
+      }
+
+      [[nodiscard]] uint64_t GetSize() const noexcept override {
+         return size;
+      }
+
+      [[nodiscard]] std::byte* GetMappedData() const noexcept override {
+         return data.get();
+      }
+
+      [[nodiscard]] uint64_t GetGpuAddress() const noexcept override {
+         return GpuAddress;
+      }
+
+    private:
+      std::unique_ptr<std::byte[]> data;
+      uint64_t size;
+   };
+
+   class NullCommandAllocator : public CommandAllocator {
+    public:
+      void Reset() override {
+      }
+   };
+
+   // Keeps every recorded command so callers can inspect what a frame would have sent to the GPU.
+   // Capacity is kept across resets, so steady state recording does not allocate.
+   class NullCommandList : public CommandList {
+    public:
+      void Reset(CommandAllocator&) override {
+         if (open) {
+            throw std::logic_error("NullCommandList reset while still open");
+         }
+         commands.clear();
+         barrierBatches = 0;
+         open = true;
+      }
+
+      void Close() override {
+         if (!open) {
+            throw std::logic_error("NullCommandList closed twice");
+         }
+         open = false;
+      }
+
+      // One Transition command per barrier. Empty batches are recorded as nothing, as on D3D12.
+      void Barriers(std::span<const TextureBarrier> barriers) override {
+         if (barriers.empty()) {
+            return;
+         }
+         for (const auto& barrier : barriers) {
+            Record({NullCommand::Op::Transition, barrier.texture, barrier.before, barrier.after});
+         }
+         barrierBatches++;
+      }
+
+      // Recorded as an Aliasing command targeting after.
+      void AliasingBarriers(std::span<const AliasingBarrier> barriers) override {
+         for (const auto& barrier : barriers) {
+            Record({NullCommand::Op::Aliasing, barrier.after, {}, {}});
+         }
+      }
+
+      void SetRenderTarget(Texture& color, Texture*) override {
+         Record({NullCommand::Op::SetRenderTarget, &color, {}, {}});
+      }
+
+      void ClearRenderTarget(Texture& color, const ClearColor&) override {
+         Record({NullCommand::Op::ClearRenderTarget, &color, {}, {}});
+      }
+
+      void ClearDepth(Texture& depth, float) override {
+         Record({NullCommand::Op::ClearDepth, &depth, {}, {}});
+      }
+
+      void SetViewport(uint32_t, uint32_t) override {
+         Record({NullCommand::Op::SetViewport, nullptr, {}, {}});
+      }
+
+      [[nodiscard]] bool IsOpen() const noexcept {
+         return open;
+      }
+
+      [[nodiscard]] std::span<const NullCommand> GetCommands() const noexcept {
+         return commands;
+      }
+
+      [[nodiscard]] uint64_t GetBarrierBatchCount() const noexcept {
+         return barrierBatches;
+      }
+
+    private:
+      std::vector<NullCommand> commands;
+      uint64_t barrierBatches{0};
+      bool open{false};
+
+      void Record(const NullCommand& command) {
+         if (!open) {
+            throw std::logic_error("NullCommandList recorded into while closed");
+         }
+         commands.push_back(command);
+      }
+   };
+
+   // Runs a simulated GPU timeline on its own thread. Submitted work occupies the timeline for
+   // commandCost per command, signals complete in submission order once the work ahead of them
+   // has finished, and presents retire on vertical blank boundaries.
+   class NullQueue : public Queue {
+    public:
+      explicit NullQueue(const NullDeviceDesc& desc) :
+          desc(desc), epoch(std::chrono::steady_clock::now()), counters{},
+          thread([this] { Run(); }) {
+      }
+
+      ~NullQueue() override {
+         {
+            std::lock_guard lock(mutex);
+            stopping = true;
+         }
+         changed.notify_all();
+         thread.join();
+      }
+
+      NullQueue(const NullQueue&) = delete;
+      NullQueue& operator=(const NullQueue&) = delete;
+
+      void Execute(std::span<CommandList* const> commandLists) override {
+         uint64_t commands = 0;
+         uint64_t barriers = 0;
+         uint64_t barrierBatches = 0;
+         uint64_t aliasingBarriers = 0;
+         for (CommandList* commandList : commandLists) {
+            auto& list = static_cast<NullCommandList&>(*commandList);
+            if (list.IsOpen()) {
+               throw std::logic_error("NullQueue executed an open command list");
+            }
+            commands += list.GetCommands().size();
+            barriers += std::ranges::count(
+                list.GetCommands(), NullCommand::Op::Transition, &NullCommand::op);
+            barrierBatches += list.GetBarrierBatchCount();
+            aliasingBarriers += std::ranges::count(
+                list.GetCommands(), NullCommand::Op::Aliasing, &NullCommand::op);
+         }
+         const auto duration = desc.commandCost * static_cast<int64_t>(commands);
+
+         {
+            std::lock_guard lock(mutex);
+            counters.executes++;
+            counters.commandLists += commandLists.size();
+            counters.commands += commands;
+            counters.barriers += barriers;
+            counters.barrierBatches += barrierBatches;
+            counters.aliasingBarriers += aliasingBarriers;
+            pending.push_back({Item::Kind::Work, duration, 0, 0});
+         }
+         changed.notify_all();
+      }
+
+      void Signal(uint64_t value) override {
+         {
+            std::lock_guard lock(mutex);
+            counters.signals++;
+            pending.push_back({Item::Kind::Signal, {}, value, 0});
+         }
+         changed.notify_all();
+      }
+
+      [[nodiscard]] uint64_t GetCompletedValue() const override {
+         std::lock_guard lock(mutex);
+         return completedValue;
+      }
+
+      bool Wait(uint64_t value, std::chrono::milliseconds timeout) override {
+         std::unique_lock lock(mutex);
+         counters.waits++;
+         return changed.wait_for(lock, timeout, [&] { return completedValue >= value; });
+      }
+
+      // Blocks while maxFrameLatency presents are already waiting for the display, then queues
+      // one more behind the work submitted so far.
+      void QueuePresent(uint32_t syncInterval) {
+         {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return queuedPresents < desc.maxFrameLatency; });
+            counters.presents++;
+            queuedPresents++;
+            pending.push_back({Item::Kind::Present, {}, 0, syncInterval});
+         }
+         changed.notify_all();
+      }
+
+      void CountResize() {
+         std::lock_guard lock(mutex);
+         counters.resizes++;
+      }
+
+      [[nodiscard]] std::chrono::nanoseconds GetRefreshInterval() const noexcept {
+         return desc.refreshInterval;
+      }
+
+      [[nodiscard]] NullDeviceCounters GetCounters() const {
+         std::lock_guard lock(mutex);
+         return counters;
+      }
+
+    private:
+      struct Item {
+         enum class Kind {
+            Work,
+            Signal,
+            Present,
+         };
+
+         Kind kind;
+         std::chrono::nanoseconds duration;
+         uint64_t value;
+         uint32_t syncInterval;
+      };
+
+      NullDeviceDesc desc;
+      std::chrono::steady_clock::time_point epoch;
+
+      mutable std::mutex mutex;
+      std::condition_variable changed;
+      std::deque<Item> pending;
+      uint64_t completedValue{0};
+      uint32_t queuedPresents{0};
+      bool stopping{false};
+      NullDeviceCounters counters;
+
+      std::thread thread;
+
+      void Run() {
+         auto busyUntil = std::chrono::steady_clock::now();
+         std::unique_lock lock(mutex);
+         while (true) {
+            changed.wait(lock, [&] { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+               return;
+            }
+            const Item item = pending.front();
+            pending.pop_front();
+
+            // Once shutting down, retire whatever is left immediately so no waiter is stranded.
+            if (!stopping) {
+               lock.unlock();
+               const auto now = std::chrono::steady_clock::now();
+               busyUntil = std::max(busyUntil, now);
+               if (item.kind == Item::Kind::Work) {
+                  busyUntil += item.duration;
+               } else if (item.kind == Item::Kind::Present && item.syncInterval > 0) {
+                  const auto sinceEpoch = busyUntil - epoch;
+                  const auto blanks = sinceEpoch / desc.refreshInterval + item.syncInterval;
+                  busyUntil = epoch + blanks * desc.refreshInterval;
+               }
+               std::this_thread::sleep_until(busyUntil);
+               lock.lock();
+            }
+
+            if (item.kind == Item::Kind::Signal) {
+               completedValue = std::max(completedValue, item.value);
+            } else if (item.kind == Item::Kind::Present) {
+               queuedPresents--;
+            }
+            changed.notify_all();
+         }
+      }
+   };
+
+   class NullSwapChain : public SwapChain {
+    public:
+      NullSwapChain(NullQueue& queue, const SwapChainDesc& desc) : queue(queue) {
+         for (uint32_t n = 0; n < desc.bufferCount; n++) {
+            backBuffers.push_back(
+                std::make_unique<NullTexture>(desc.width, desc.height, ResourceState::Present));
+         }
+      }
+
+      [[nodiscard]] uint32_t GetBufferCount() const noexcept override {
+         return static_cast<uint32_t>(backBuffers.size());
+      }
+
+      [[nodiscard]] uint32_t GetCurrentBackBufferIndex() const override {
+         return backBufferIndex;
+      }
+
+      [[nodiscard]] Texture& GetBackBuffer(uint32_t index) override {
+         return *backBuffers.at(index);
+      }
+
+      [[nodiscard]] std::chrono::nanoseconds GetRefreshInterval() const override {
+         return queue.GetRefreshInterval();
+      }
+
+      PresentResult Present(uint32_t syncInterval) override {
+         if (deviceLost) {
+            return PresentResult::DeviceLost;
+         }
+         queue.QueuePresent(syncInterval);
+         backBufferIndex = (backBufferIndex + 1) % GetBufferCount();
+         return PresentResult::Ok;
+      }
+
+      PresentResult Resize(uint32_t width, uint32_t height) override {
+         if (deviceLost) {
+            return PresentResult::DeviceLost;
+         }
+         queue.CountResize();
+         // Stands in for the buffers being recreated, which start out ready to present.
+         for (auto& backBuffer : backBuffers) {
+            backBuffer->Resize(width, height);
+            backBuffer->SetCommittedState(ResourceState::Present);
+         }
+         backBufferIndex = 0;
+         return PresentResult::Ok;
+      }
+
+      // Makes every following Present and Resize report a lost device.
+      void SimulateDeviceLost() noexcept {
+         deviceLost = true;
+      }
+
+    private:
+      NullQueue& queue;
+      std::vector<std::unique_ptr<NullTexture>> backBuffers;
+      uint32_t backBufferIndex{0};
+      bool deviceLost{false};
+   };
+
+   class NullDevice : public Device {
+    public:
+      explicit NullDevice(const NullDeviceDesc& desc = {}) : queue(desc) {
+      }
+
+      [[nodiscard]] Queue& GetQueue() noexcept override {
+         return queue;
+      }
+
+      std::unique_ptr<CommandAllocator> CreateCommandAllocator() override {
+         return std::make_unique<NullCommandAllocator>();
+      }
+
+      std::unique_ptr<CommandList> CreateCommandList() override {
+         return std::make_unique<NullCommandList>();
+      }
+
+      std::unique_ptr<SwapChain> CreateSwapChain(const SwapChainDesc& desc) override {
+         return std::make_unique<NullSwapChain>(queue, desc);
+      }
+
+      std::unique_ptr<Texture> CreateDepthTarget(uint32_t width, uint32_t height) override {
+         return std::make_unique<NullTexture>(width, height, ResourceState::DepthWrite);
+      }
+
+      std::unique_ptr<UploadBuffer> CreateUploadBuffer(uint64_t size) override {
+         return std::make_unique<NullUploadBuffer>(size);
+      }
+
+      // Tightly packed texels rounded up to D3D12's default 64KB placement alignment.
+      [[nodiscard]] AllocationInfo GetAllocationInfo(const TextureDesc& desc) override {
+         constexpr uint64_t alignment = 64 * 1024;
+         const uint64_t bytesPerTexel = desc.format == TextureFormat::Rgba16Float ? 8 : 4;
+         const uint64_t size = uint64_t{desc.width} * desc.height * bytesPerTexel;
+         return {(size + alignment - 1) / alignment * alignment, alignment};
+      }
+
+      std::unique_ptr<Heap> CreateHeap(uint64_t size) override {
+         return std::make_unique<NullHeap>(size);
+      }
+
+      std::unique_ptr<Texture> CreatePlacedTexture(Heap& heap,
+                                                   uint64_t offset,
+                                                   const TextureDesc& desc) override {
+         const AllocationInfo info = GetAllocationInfo(desc);
+         if (offset % info.alignment != 0 || offset + info.size > heap.GetSize()) {
+            throw std::out_of_range("NullDevice texture placed outside its heap or misaligned");
+         }
+         return std::make_unique<NullTexture>(desc.width,
+                                              desc.height,
+                                              desc.usage == TextureUsage::DepthStencil
+                                                  ? ResourceState::DepthWrite
+                                                  : ResourceState::RenderTarget);
+      }
+
+      [[nodiscard]] NullDeviceCounters GetCounters() const {
+         return queue.GetCounters();
+      }
+
+    private:
+      NullQueue queue;
+   };
+}
@@ -0,0 +1,517 @@
+//
+// RenderGraph.h - Frame described as passes over resources, compiled into a culled schedule
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "Graphics/AliasingPlanner.h"
+#include "Graphics/DeferredDeletionQueue.h"
+#include "Graphics/Device.h"
+#include "Graphics/ResourceStateTracker.h"
+
+namespace TX::Graphics {
+
+   // Index of a resource within one frame's graph.
+   struct RenderGraphResource {
+      uint32_t index;
+   };
+
+   enum class PassQueue : uint8_t {
+      Graphics,
+      Compute,
+      Copy,
+   };
+
+   class RenderGraph;
+
+   // Declares what one pass reads and writes. Returned by RenderGraph::AddPass.
+   class RenderGraphPassBuilder {
+    public:
+      RenderGraphPassBuilder& Read(RenderGraphResource resource, ResourceState state);
+      RenderGraphPassBuilder& Write(RenderGraphResource resource, ResourceState state);
+      // Keeps the pass even if nothing reads what it writes.
+      RenderGraphPassBuilder& HasSideEffects();
+
+    private:
+      friend class RenderGraph;
+
+      RenderGraphPassBuilder(RenderGraph& graph, uint32_t pass) noexcept :
+          graph(graph), pass(pass) {
+      }
+
+      RenderGraph& graph;
+      uint32_t pass;
+   };
+
+   // The frame is declared again every frame: import the textures, add passes in submission order
+   // with the resources they read and write, mark what must be produced, then Compile and Execute.
+   // Compile walks back from the outputs and side effect passes and drops every pass that does not
+   // contribute to them, works out the state each surviving pass needs its resources in, and
+   // notes where a pass consumes the output of a pass assigned to another queue. The result only
+   // depends on the graph's topology, so as long as the same passes declare the same accesses it
+   // is reused from the previous frame rather than compiled again. Imported textures may differ
+   // from frame to frame without invalidating it.
+   //
+   // Execute only drives one queue so far, as Device only has one. Every scheduled pass is
+   // recorded into one command list in schedule order, whichever queue it was assigned, so the
+   // waits the schedule notes are met by that order and nothing overlaps across queues. They are
+   // computed for an executor that splits the schedule across queues.
+   //
+   // Textures that only live within the frame are created through the graph instead. Compiling
+   // works out which scheduled passes each one is used between and places those that are never
+   // alive at the same time in the same memory of one shared heap, with an aliasing barrier ahead
+   // of the pass that takes the memory over. An aliased texture's contents are undefined when its
+   // first pass starts, so that pass has to clear or entirely overwrite it. The heap and textures
+   // are kept for as long as the compiled schedule is.
+   //
+   //    graph.Reset();
+   //    auto target = graph.ImportTexture(backBuffer);
+   //    graph.AddPass("Clear", [](CommandList& list, const RenderGraph& graph) { ... })
+   //        .Write(target, ResourceState::RenderTarget);
+   //    graph.SetOutput(target, ResourceState::Present);
+   //    graph.Compile();
+   //    graph.Execute(commandList, states);
+   class RenderGraph {
+    public:
+      using ExecuteFunction = std::function<void(CommandList&, const RenderGraph&)>;
+
+      static constexpr uint32_t NoPass = UINT32_MAX;
+
+      // A state change recorded ahead of a pass, or after the last one for outputs.
+      struct Transition {
+         uint32_t resource;
+         ResourceState state;
+      };
+
+      struct CompiledPass {
+         uint32_t pass;
+         PassQueue queue;
+         // Bit per PassQueue this pass has to wait on before it starts, because it consumes
+         // something a pass on that queue produced. Execute records every pass on one list, which
+         // already orders it after its producers, so it does not use these.
+         uint8_t queueWaits;
+         uint32_t firstTransition;
+         uint32_t transitionCount;
+         uint32_t firstAliasingBarrier;
+         uint32_t aliasingBarrierCount;
+      };
+
+      struct CompileStats {
+         uint64_t compiles;
+         uint64_t cacheHits;
+         uint32_t culledPasses;
+         uint32_t transitions;
+         // Memory the transient textures take, and what they would without aliasing.
+         uint64_t transientHeapSize;
+         uint64_t transientUnaliasedSize;
+      };
+
+      // Transient textures are created on device, and replaced ones are handed to deletionQueue.
+      RenderGraph(Device& device, DeferredDeletionQueue& deletionQueue) noexcept :
+          device(device), deletionQueue(deletionQueue) {
+      }
+
+      // Starts declaring a new frame. The compiled schedule is kept for comparison.
+      void Reset() {
+         passes.clear();
+         accesses.clear();
+         textures.clear();
+         transients.clear();
+         outputs.clear();
+         topology.clear();
+         compiledThisFrame = false;
+      }
+
+      RenderGraphResource ImportTexture(Texture& texture) {
+         textures.push_back(&texture);
+         return {static_cast<uint32_t>(textures.size() - 1)};
+      }
+
+      // A texture that lives only within this frame. It is not backed by memory until Compile.
+      RenderGraphResource CreateTexture(const TextureDesc& desc) {
+         transients.push_back({static_cast<uint32_t>(textures.size()), desc});
+         textures.push_back(nullptr);
+         return {static_cast<uint32_t>(textures.size() - 1)};
+      }
+
+      // name must outlive the frame; string literals are expected.
+      RenderGraphPassBuilder AddPass(std::string_view name,
+                                     ExecuteFunction execute,
+                                     PassQueue queue = PassQueue::Graphics) {
+         passes.push_back(Pass{.name = name,
+                               .queue = queue,
+                               .sideEffects = false,
+                               .firstAccess = static_cast<uint32_t>(accesses.size()),
+                               .accessCount = 0,
+                               .execute = std::move(execute)});
+         return {*this, static_cast<uint32_t>(passes.size() - 1)};
+      }
+
+      // resource must be produced this frame and left in state once the graph has executed.
+      // Compile throws std::logic_error if it is a transient texture that no pass writes.
+      void SetOutput(RenderGraphResource resource, ResourceState state) {
+         outputs.push_back({resource.index, state});
+      }
+
+      // Compiles the declared frame, or reuses the previous schedule if the topology matches.
+      void Compile() {
+         BuildTopology();
+         if (hasSchedule && topology == compiledTopology) {
+            stats.cacheHits++;
+         } else {
+            CompileSchedule();
+            AllocateTransients();
+            compiledTopology = topology;
+            hasSchedule = true;
+            stats.compiles++;
+         }
+         for (uint32_t t = 0; t < transients.size(); t++) {
+            textures[transients[t].resource] = transientTextures[t].get();
+         }
+         compiledThisFrame = true;
+      }
+
+      // Records every scheduled pass into commandList, whatever queue it was assigned. Transitions
+      // go through states, which batches them per pass and resolves the first use of each texture
+      // at submit.
+      void Execute(CommandList& commandList, ResourceStateTracker& states) const {
+         if (!compiledThisFrame) {
+            throw std::logic_error("RenderGraph executed without compiling this frame");
+         }
+         for (const auto& compiled : compiledPasses) {
+            commandList.AliasingBarriers(std::span(aliasingBarriers)
+                                             .subspan(compiled.firstAliasingBarrier,
+                                                      compiled.aliasingBarrierCount));
+            RequireAll(states, compiled.firstTransition, compiled.transitionCount);
+            states.Flush(commandList);
+            passes[compiled.pass].execute(commandList, *this);
+         }
+         // Left pending; the next flush, or Submit, records them.
+         RequireAll(states, finalTransitionStart, finalTransitionCount);
+      }
+
+      [[nodiscard]] Texture& GetTexture(RenderGraphResource resource) const {
+         return *textures[resource.index];
+      }
+
+      [[nodiscard]] std::string_view GetPassName(uint32_t pass) const noexcept {
+         return passes[pass].name;
+      }
+
+      [[nodiscard]] const std::vector<CompiledPass>& GetSchedule() const noexcept {
+         return compiledPasses;
+      }
+
+      [[nodiscard]] const CompileStats& GetStats() const noexcept {
+         return stats;
+      }
+
+    private:
+      friend class RenderGraphPassBuilder;
+
+      struct Pass {
+         std::string_view name;
+         PassQueue queue;
+         bool sideEffects;
+         uint32_t firstAccess;
+         uint32_t accessCount;
+         ExecuteFunction execute;
+      };
+
+      struct Access {
+         uint32_t resource;
+         ResourceState state;
+         bool write;
+      };
+
+      struct Transient {
+         uint32_t resource;
+         TextureDesc desc;
+      };
+
+      Device& device;
+      DeferredDeletionQueue& deletionQueue;
+
+      // Declared this frame.
+      std::vector<Pass> passes;
+      std::vector<Access> accesses;
+      // Transient textures are null until Compile.
+      std::vector<Texture*> textures;
+      std::vector<Transient> transients;
+      std::vector<Transition> outputs;
+      std::vector<uint64_t> topology;
+      bool compiledThisFrame{false};
+
+      // Compiled from compiledTopology.
+      bool hasSchedule{false};
+      std::vector<uint64_t> compiledTopology;
+      std::vector<CompiledPass> compiledPasses;
+      std::vector<Transition> transitions;
+      uint32_t finalTransitionStart{0};
+      uint32_t finalTransitionCount{0};
+      // The heap goes before the textures placed in it, so that it is destroyed after them.
+      std::unique_ptr<Heap> transientHeap;
+      std::vector<std::unique_ptr<Texture>> transientTextures;
+      std::vector<AliasingBarrier> aliasingBarriers;
+      CompileStats stats{};
+
+      // Compile scratch, kept for its capacity.
+      std::vector<uint32_t> dependencies;
+      std::vector<uint32_t> firstDependency;
+      std::vector<uint32_t> lastWriter;
+      std::vector<uint8_t> live;
+      std::vector<uint32_t> stack;
+      std::vector<int32_t> currentState;
+      std::vector<uint32_t> transientIndex;
+      std::vector<uint32_t> transientRequest;
+      std::vector<AliasingRequest> aliasingRequests;
+      std::vector<uint32_t> requestTransient;
+      AliasingPlan aliasingPlan;
+      AliasingPlanner aliasingPlanner;
+
+      void AddAccess(uint32_t pass, RenderGraphResource resource, ResourceState state, bool write) {
+         if (resource.index >= textures.size()) {
+            throw std::out_of_range("RenderGraph access to a resource that was not declared");
+         }
+         if (passes[pass].firstAccess + passes[pass].accessCount != accesses.size()) {
+            throw std::logic_error("RenderGraph accesses must be declared before the next pass");
+         }
+         accesses.push_back({resource.index, state, write});
+         passes[pass].accessCount++;
+      }
+
+      // Everything the schedule depends on, packed so that comparing two frames is one pass over
+      // an array.
+      void BuildTopology() {
+         topology.push_back(textures.size());
+         for (const auto& transient : transients) {
+            const auto& desc = transient.desc;
+            topology.push_back(transient.resource);
+            topology.push_back(desc.width | static_cast<uint64_t>(desc.height) << 24 |
+                               static_cast<uint64_t>(desc.format) << 48 |
+                               static_cast<uint64_t>(desc.usage) << 56);
+         }
+         for (const auto& pass : passes) {
+            topology.push_back(static_cast<uint64_t>(pass.queue) |
+                               static_cast<uint64_t>(pass.sideEffects) << 8 |
+                               static_cast<uint64_t>(pass.accessCount) << 32);
+            for (uint32_t a = 0; a < pass.accessCount; a++) {
+               const auto& access = accesses[pass.firstAccess + a];
+               topology.push_back(access.resource |
+                                  static_cast<uint64_t>(access.state) << 32 |
+                                  static_cast<uint64_t>(access.write) << 40);
+            }
+         }
+         for (const auto& output : outputs) {
+            topology.push_back(output.resource | static_cast<uint64_t>(output.state) << 32 |
+                               uint64_t{1} << 48);
+         }
+      }
+
+      void CompileSchedule() {
+         const auto passCount = static_cast<uint32_t>(passes.size());
+
+         // Every access depends on the last pass that wrote the resource before it. Writes do
+         // too, since a pass may only partly overwrite what was there.
+         dependencies.clear();
+         firstDependency.assign(passCount + 1, 0);
+         lastWriter.assign(textures.size(), NoPass);
+         for (uint32_t p = 0; p < passCount; p++) {
+            firstDependency[p] = static_cast<uint32_t>(dependencies.size());
+            const auto& pass = passes[p];
+            for (uint32_t a = 0; a < pass.accessCount; a++) {
+               const auto& access = accesses[pass.firstAccess + a];
+               if (lastWriter[access.resource] != NoPass && lastWriter[access.resource] != p) {
+                  dependencies.push_back(lastWriter[access.resource]);
+               }
+            }
+            for (uint32_t a = 0; a < pass.accessCount; a++) {
+               const auto& access = accesses[pass.firstAccess + a];
+               if (access.write) {
+                  lastWriter[access.resource] = p;
+               }
+            }
+         }
+         firstDependency[passCount] = static_cast<uint32_t>(dependencies.size());
+
+         // Transients are still null here. One that nothing writes would never be given memory,
+         // and there would be nothing to transition at the end of the frame.
+         for (const auto& output : outputs) {
+            if (!textures[output.resource] && lastWriter[output.resource] == NoPass) {
+               throw std::logic_error("RenderGraph output is a transient texture no pass writes");
+            }
+         }
+
+         // Keep whatever the outputs and side effects transitively depend on.
+         live.assign(passCount, 0);
+         stack.clear();
+         const auto keep = [&](uint32_t p) {
+            if (p != NoPass && !live[p]) {
+               live[p] = 1;
+               stack.push_back(p);
+            }
+         };
+         for (const auto& output : outputs) {
+            keep(lastWriter[output.resource]);
+         }
+         for (uint32_t p = 0; p < passCount; p++) {
+            if (passes[p].sideEffects) {
+               keep(p);
+            }
+         }
+         while (!stack.empty()) {
+            const uint32_t p = stack.back();
+            stack.pop_back();
+            for (uint32_t d = firstDependency[p]; d < firstDependency[p + 1]; d++) {
+               keep(dependencies[d]);
+            }
+         }
+
+         // Declaration order is a valid submission order, since dependencies only point back.
+         // Track the state each resource is left in so that only changes become transitions.
+         compiledPasses.clear();
+         transitions.clear();
+         currentState.assign(textures.size(), -1);
+         uint32_t culled = 0;
+         for (uint32_t p = 0; p < passCount; p++) {
+            if (!live[p]) {
+               culled++;
+               continue;
+            }
+            const auto& pass = passes[p];
+            CompiledPass compiled{.pass = p,
+                                  .queue = pass.queue,
+                                  .queueWaits = 0,
+                                  .firstTransition = static_cast<uint32_t>(transitions.size()),
+                                  .transitionCount = 0,
+                                  .firstAliasingBarrier = 0,
+                                  .aliasingBarrierCount = 0};
+            for (uint32_t a = 0; a < pass.accessCount; a++) {
+               const auto& access = accesses[pass.firstAccess + a];
+               AddTransition(access.resource, access.state, compiled.transitionCount);
+            }
+            for (uint32_t d = firstDependency[p]; d < firstDependency[p + 1]; d++) {
+               const PassQueue producer = passes[dependencies[d]].queue;
+               if (producer != pass.queue) {
+                  compiled.queueWaits |= QueueBit(producer);
+               }
+            }
+            compiledPasses.push_back(compiled);
+         }
+
+         finalTransitionStart = static_cast<uint32_t>(transitions.size());
+         finalTransitionCount = 0;
+         for (const auto& output : outputs) {
+            AddTransition(output.resource, output.state, finalTransitionCount);
+         }
+
+         stats.culledPasses = culled;
+         stats.transitions = static_cast<uint32_t>(transitions.size());
+      }
+
+      // Places the transients the schedule uses into a new heap. The previous heap and textures
+      // may still be in use by frames in flight, so they go to the deletion queue.
+      void AllocateTransients() {
+         // Lifetimes, in scheduled passes. Transients only culled passes use get no memory.
+         transientIndex.assign(textures.size(), NoPass);
+         for (uint32_t t = 0; t < transients.size(); t++) {
+            transientIndex[transients[t].resource] = t;
+         }
+         transientRequest.assign(transients.size(), NoPass);
+         aliasingRequests.clear();
+         requestTransient.clear();
+         for (uint32_t s = 0; s < compiledPasses.size(); s++) {
+            const auto& pass = passes[compiledPasses[s].pass];
+            for (uint32_t a = 0; a < pass.accessCount; a++) {
+               const uint32_t t = transientIndex[accesses[pass.firstAccess + a].resource];
+               if (t == NoPass) {
+                  continue;
+               }
+               if (transientRequest[t] == NoPass) {
+                  const AllocationInfo info = device.GetAllocationInfo(transients[t].desc);
+                  transientRequest[t] = static_cast<uint32_t>(aliasingRequests.size());
+                  aliasingRequests.push_back({info.size, info.alignment, s, s});
+                  requestTransient.push_back(t);
+               }
+               aliasingRequests[transientRequest[t]].lastPass = s;
+            }
+         }
+         aliasingPlanner.Plan(aliasingRequests, aliasingPlan);
+
+         for (auto& texture : transientTextures) {
+            deletionQueue.Release(std::move(texture));
+         }
+         deletionQueue.Release(std::move(transientHeap));
+         transientTextures.clear();
+         transientTextures.resize(transients.size());
+         if (aliasingPlan.heapSize > 0) {
+            transientHeap = device.CreateHeap(aliasingPlan.heapSize);
+         }
+         for (uint32_t r = 0; r < aliasingRequests.size(); r++) {
+            transientTextures[requestTransient[r]] = device.CreatePlacedTexture(
+                *transientHeap, aliasingPlan.offsets[r], transients[requestTransient[r]].desc);
+         }
+
+         aliasingBarriers.clear();
+         for (const auto& planned : aliasingPlan.barriers) {
+            auto& compiled = compiledPasses[planned.pass];
+            if (compiled.aliasingBarrierCount == 0) {
+               compiled.firstAliasingBarrier = static_cast<uint32_t>(aliasingBarriers.size());
+            }
+            compiled.aliasingBarrierCount++;
+            Texture* before = planned.before == AliasingPlan::NoResource
+                                  ? nullptr
+                                  : transientTextures[requestTransient[planned.before]].get();
+            aliasingBarriers.push_back(
+                {before, transientTextures[requestTransient[planned.after]].get()});
+         }
+
+         stats.transientHeapSize = aliasingPlan.heapSize;
+         stats.transientUnaliasedSize = aliasingPlan.unaliasedSize;
+      }
+
+      static constexpr uint8_t QueueBit(PassQueue queue) noexcept {
+         return static_cast<uint8_t>(1u << static_cast<uint32_t>(queue));
+      }
+
+      void AddTransition(uint32_t resource, ResourceState state, uint32_t& count) {
+         if (currentState[resource] == static_cast<int32_t>(state)) {
+            return;
+         }
+         currentState[resource] = static_cast<int32_t>(state);
+         transitions.push_back({resource, state});
+         count++;
+      }
+
+      void RequireAll(ResourceStateTracker& states, uint32_t first, uint32_t count) const {
+         for (uint32_t t = first; t < first + count; t++) {
+            states.Require(*textures[transitions[t].resource], transitions[t].state);
+         }
+      }
+   };
+
+   inline RenderGraphPassBuilder& RenderGraphPassBuilder::Read(RenderGraphResource resource,
+                                                               ResourceState state) {
+      graph.AddAccess(pass, resource, state, false);
+      return *this;
+   }
+
+   inline RenderGraphPassBuilder& RenderGraphPassBuilder::Write(RenderGraphResource resource,
+                                                                ResourceState state) {
+      graph.AddAccess(pass, resource, state, true);
+      return *this;
+   }
+
+   inline RenderGraphPassBuilder& RenderGraphPassBuilder::HasSideEffects() {
+      graph.passes[pass].sideEffects = true;
+      return *this;
+   }
+}
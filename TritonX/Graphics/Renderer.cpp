@@ -0,0 +1,277 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "Renderer.h"
+#include "Logger.h"
+#include "System/BinaryLog.h"
+
+namespace TX::Graphics {
+
+   namespace {
+      // DirectX::Colors::CornflowerBlue
+      constexpr ClearColor clearColor = {0.392156899f, 0.584313750f, 0.929411829f, 1.0f};
+
+      // A frame fence wait longer than this is reported, and then waited on again.
+      constexpr std::chrono::milliseconds gpuHangWarning{2000};
+   }
+
+   Renderer::Renderer(Device& device) :
+       device(device), window(nullptr), outputWidth(0), outputHeight(0), framesInFlight(0),
+       frameIndex(0), frameFenceValues{}, timeline(device.GetQueue()), deletionQueue(timeline),
+       uploadRing(device, timeline, uploadRingFrameSize, MaxFramesInFlight), recorder(device),
+       frameGraph(device, deletionQueue),
+       simulation([this](StepTimer const& timer, const SimulationState& state) {
+          return Update(timer, state);
+       }),
+       backBufferIndex(0), frameTiming(clock.Frequency()), frameStart(0), fenceWait(0),
+       presentWait(0) {
+      SetFramesInFlight(2);
+   }
+
+   Renderer::~Renderer() {
+      simulation.Stop();
+      WaitForGpu();
+   }
+
+   void Renderer::Initialize(void* window, uint32_t width, uint32_t height) {
+      this->window = window;
+      outputWidth = width;
+      outputHeight = height;
+
+      CreateResources();
+
+      auto& timer = simulation.GetTimer();
+      timer.SetFixedTimeStep(true);
+      timer.SetTargetElapsedSeconds(1.0 / 240);
+      // Enough to keep up with a 30Hz present rate, anything slower drops simulation time instead
+      // of spiralling.
+      timer.SetMaxUpdatesPerTick(8);
+   }
+
+   void Renderer::OnWindowSizeChanged(uint32_t width, uint32_t height) {
+      width = std::max(width, 1U);
+      height = std::max(height, 1U);
+      if (!swapChain || (width == outputWidth && height == outputHeight)) {
+         return;
+      }
+
+      outputWidth = width;
+      outputHeight = height;
+      CreateResources();
+
+      // The frame that spans the resize says nothing about steady state.
+      frameStart = 0;
+   }
+
+   void Renderer::SetThreadedSimulation(bool threaded) {
+      if (threaded) {
+         simulation.Start();
+      } else {
+         simulation.Stop();
+      }
+   }
+
+   void Renderer::SetFramesInFlight(uint32_t count) {
+      count = std::clamp(count, 1U, MaxFramesInFlight);
+      if (count == framesInFlight) {
+         return;
+      }
+
+      // Every slot is idle once the GPU is drained, so they can be renumbered freely.
+      WaitForGpu();
+      framesInFlight = count;
+      frameIndex = 0;
+
+      // Timing from the old depth says nothing about the new one, and the drain itself is not a
+      // frame.
+      frameTiming.Reset();
+      frameStart = 0;
+   }
+
+   void Renderer::Tick() {
+      if (!simulation.IsThreaded()) {
+         simulation.Tick();
+      }
+
+      const SimulationFrame& frame = simulation.Latest();
+      const double alpha = simulation.GetInterpolationAlpha(frame);
+      TX_BLOG(Debug, "Tick simulation frame {} alpha {}", frame.current.frame, alpha);
+
+      Render(Interpolate(frame.previous, frame.current, alpha));
+   }
+
+   SimulationState Renderer::Update(StepTimer const& timer, const SimulationState& state) {
+      float elapsedTime = float(timer.GetElapsedSeconds());
+
+      (void)elapsedTime;
+      (void)state;
+
+      return SimulationState{.frame = timer.GetFrameCount(),
+                             .totalSeconds = timer.GetTotalSeconds()};
+   }
+
+   void Renderer::Render(const SimulationState& state) {
+      if (state.frame == 0) {
+         return;
+      }
+
+      RecordFrameTiming();
+      uploadRing.BeginFrame();
+
+      TX_LOG_EVERY_N(Trace, Graphics, 240)
+          << L"Render simulation frame " << state.frame << std::endl;
+
+      // Reset Command List and Allocator
+      BuildFrameGraph();
+      frameGraph.Compile();
+
+      recorder.BeginFrame(1);
+      auto& commandList = recorder.Open(0);
+      frameGraph.Execute(commandList, recorder.GetStateTracker(0));
+
+      Present();
+   }
+
+   void Renderer::BuildFrameGraph() {
+      frameGraph.Reset();
+      const auto backBuffer = frameGraph.ImportTexture(swapChain->GetBackBuffer(backBufferIndex));
+      const auto depth = frameGraph.ImportTexture(*depthStencil);
+
+      frameGraph
+          .AddPass("Clear",
+                   [this, backBuffer, depth](CommandList& commandList, const RenderGraph& graph) {
+                      Clear(commandList, graph.GetTexture(backBuffer), graph.GetTexture(depth));
+                   })
+          .Write(backBuffer, ResourceState::RenderTarget)
+          .Write(depth, ResourceState::DepthWrite);
+
+      frameGraph.SetOutput(backBuffer, ResourceState::Present);
+   }
+
+   void Renderer::Clear(CommandList& commandList, Texture& renderTarget, Texture& depth) {
+      // Clear the Views
+      commandList.SetRenderTarget(renderTarget, &depth);
+      commandList.ClearRenderTarget(renderTarget, clearColor);
+      commandList.ClearDepth(depth, 1.0f);
+
+      // Set the viewport and scissor rect.
+      commandList.SetViewport(outputWidth, outputHeight);
+   }
+
+   void Renderer::Present() {
+      // Send the command list off to the GPU for processing. MoveToNextFrame signals the
+      // timeline's next value behind it.
+      recorder.Submit(device.GetQueue(), timeline.GetNextValue());
+
+      // A sync interval of one blocks until VSync, putting the application to sleep until the
+      // next VSync. This ensures we don't waste any cycles rendering frames that will never be
+      // displayed to the screen.
+      const uint64_t presentStart = clock.Now();
+      const PresentResult result = swapChain->Present(1);
+      presentWait += clock.Now() - presentStart;
+
+      // If the device was reset we must completely reinitialize the renderer.
+      if (result == PresentResult::DeviceLost) {
+         OnDeviceLost();
+      } else {
+         MoveToNextFrame();
+      }
+   }
+
+   void Renderer::MoveToNextFrame() {
+      // Schedule a Signal command in the queue.
+      const uint64_t currentFenceValue = timeline.Signal();
+      frameFenceValues[frameIndex] = currentFenceValue;
+      uploadRing.EndFrame(currentFenceValue);
+
+      // Advance to the next frame slot and back buffer. The two cycle independently.
+      frameIndex = (frameIndex + 1) % framesInFlight;
+      backBufferIndex = swapChain->GetCurrentBackBufferIndex();
+
+      // If the GPU has not finished the last frame recorded into this slot, wait for it.
+      const bool mustWait = !timeline.IsComplete(frameFenceValues[frameIndex]);
+      if (mustWait) {
+         const uint64_t waitStart = clock.Now();
+         while (!timeline.WaitFor(frameFenceValues[frameIndex], gpuHangWarning)) {
+            TX_LOG_RATE_LIMITED(Warn, Graphics, 1)
+                << L"GPU has not reached fence " << frameFenceValues[frameIndex] << L" after "
+                << gpuHangWarning.count() << L"ms, still waiting" << std::endl;
+         }
+         TX_LOG_RATE_LIMITED(Debug, Graphics, 2)
+             << L"Waited on GPU for frame slot " << frameIndex << std::endl;
+         fenceWait += clock.Now() - waitStart;
+      }
+
+      // Everything released before the frames that have now completed can go.
+      deletionQueue.Collect();
+      TX_BLOG(Debug,
+              "MoveToNextFrame signalled {} frame slot {} back buffer {} waited {}",
+              currentFenceValue,
+              frameIndex,
+              backBufferIndex,
+              mustWait);
+   }
+
+   void Renderer::RecordFrameTiming() {
+      const uint64_t now = clock.Now();
+      if (frameStart != 0) {
+         frameTiming.Record(FrameTimingSample{
+             .frame = now - frameStart, .fenceWait = fenceWait, .presentWait = presentWait});
+      }
+      frameStart = now;
+      fenceWait = 0;
+      presentWait = 0;
+
+      // Roughly every ten seconds at 60Hz. Sampled by hand rather than with TX_LOG_EVERY_N so
+      // that the window is only summarized for the frames that actually log it.
+      static Log::Sampler timingLogSampler;
+      if (Log::ShouldLog<Log::Level::Debug, Log::Category::Graphics>() &&
+          timingLogSampler.Allow(600)) {
+         const FrameTimingSnapshot timing = frameTiming.Summarize();
+         TX_LOG(Debug, Graphics)
+             << ToString(timing.bound) << L" bound over " << timing.frameCount
+             << L" frames: frame " << timing.frameMs << L"ms cpu " << timing.cpuMs
+             << L"ms fence wait " << timing.fenceWaitMs << L"ms present wait "
+             << timing.presentWaitMs << L"ms" << std::endl;
+      }
+   }
+
+   void Renderer::WaitForGpu() noexcept {
+      try {
+         timeline.WaitForIdle();
+      } catch (...) {
+         // Nothing to wait for if the queue cannot be signalled; the device is already gone.
+      }
+   }
+
+   void Renderer::CreateResources() {
+      if (swapChain) {
+         // DXGI requires the GPU to be done with every back buffer before resizing them, and every
+         // frame renders into one, so this is the one wait that cannot be deferred.
+         timeline.Wait(timeline.GetIssuedValue());
+         if (swapChain->Resize(outputWidth, outputHeight) == PresentResult::DeviceLost) {
+            OnDeviceLost();
+            return;
+         }
+      } else {
+         swapChain = device.CreateSwapChain(SwapChainDesc{.window = window,
+                                                          .width = outputWidth,
+                                                          .height = outputHeight,
+                                                          .bufferCount = swapBufferCount});
+      }
+
+      backBufferIndex = swapChain->GetCurrentBackBufferIndex();
+
+      // Frames still in flight may be using the old depth target.
+      deletionQueue.Release(std::move(depthStencil));
+      depthStencil = device.CreateDepthTarget(outputWidth, outputHeight);
+
+      const auto refreshInterval = swapChain->GetRefreshInterval();
+      frameTiming.SetRefreshInterval(static_cast<uint64_t>(
+          std::chrono::duration<double>(refreshInterval).count() * clock.Frequency()));
+   }
+
+   void Renderer::OnDeviceLost() {
+   }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Clock.h"
+#include "Graphics/CommandRecorder.h"
+#include "Graphics/DeferredDeletionQueue.h"
+#include "Graphics/Device.h"
+#include "Graphics/FrameTiming.h"
+#include "Graphics/RenderGraph.h"
+#include "Graphics/Timeline.h"
+#include "Graphics/UploadRing.h"
+#include "StepTimer.h"
+#include "System/Simulation.h"
+
+namespace TX::Graphics {
+
+   // The per frame Tick/Render/Present loop, written only against the Device interfaces so the
+   // same code runs on D3D12 or headless on a NullDevice.
+   class Renderer {
+    public:
+      static constexpr uint32_t MaxFramesInFlight = 4;
+
+      explicit Renderer(Device& device);
+      ~Renderer();
+
+      Renderer(const Renderer&) = delete;
+      Renderer& operator=(const Renderer&) = delete;
+
+      // window is handed to the swap chain untouched; see SwapChainDesc.
+      void Initialize(void* window, uint32_t width, uint32_t height);
+      void Tick();
+
+      // Recreates the size dependent resources. Call from the thread that calls Tick.
+      void OnWindowSizeChanged(uint32_t width, uint32_t height);
+
+      // Run the fixed step Update loop on a dedicated thread instead of inside Tick(). Update then
+      // executes off the message pump thread and must only touch state it returns.
+      void SetThreadedSimulation(bool threaded);
+
+      // How many frames the CPU may record ahead of the GPU, independent of the swap chain's buffer
+      // count. Clamped to [1, MaxFramesInFlight]. Drains the GPU when changed.
+      void SetFramesInFlight(uint32_t count);
+
+      [[nodiscard]] uint32_t GetFramesInFlight() const noexcept {
+         return framesInFlight;
+      }
+
+      [[nodiscard]] Simulation& GetSimulation() noexcept {
+         return simulation;
+      }
+
+      [[nodiscard]] Timeline& GetTimeline() noexcept {
+         return timeline;
+      }
+
+      // For anything the GPU may still be reading when it is replaced. Emptied once per frame.
+      [[nodiscard]] DeferredDeletionQueue& GetDeletionQueue() noexcept {
+         return deletionQueue;
+      }
+
+      // Per frame constants, vertices and instance data. Allocations are valid from Render until
+      // the frame is presented.
+      [[nodiscard]] UploadRing& GetUploadRing() noexcept {
+         return uploadRing;
+      }
+
+      // Rolling split of frame time into CPU work and fence and present stalls, with a CPU, GPU or
+      // VSync bound verdict. ReadSnapshot() on the result may be called from one thread other than
+      // the one calling Tick().
+      [[nodiscard]] FrameTiming& GetFrameTiming() noexcept {
+         return frameTiming;
+      }
+
+      void WaitForGpu() noexcept;
+
+    private:
+      static const uint32_t swapBufferCount = 2;
+      static constexpr uint64_t uploadRingFrameSize = 4 * 1024 * 1024;
+
+      Device& device;
+
+      void* window;
+      uint32_t outputWidth;
+      uint32_t outputHeight;
+
+      // Per frame slot state. The CPU may not start recording into a slot until the fence reaches
+      // the value signalled after the last frame recorded into it.
+      uint32_t framesInFlight;
+      uint32_t frameIndex;
+      std::array<uint64_t, MaxFramesInFlight> frameFenceValues;
+
+      Timeline timeline;
+      DeferredDeletionQueue deletionQueue;
+      UploadRing uploadRing;
+      CommandRecorder recorder;
+      RenderGraph frameGraph;
+
+      std::unique_ptr<SwapChain> swapChain;
+      std::unique_ptr<Texture> depthStencil;
+
+      Simulation simulation;
+
+      uint32_t backBufferIndex;
+
+      // Time blocked in the current frame, in clock counts. Frames run from one Render to the next.
+      DefaultClock clock;
+      FrameTiming frameTiming;
+      uint64_t frameStart;
+      uint64_t fenceWait;
+      uint64_t presentWait;
+
+      void CreateResources();
+
+      void OnDeviceLost();
+
+      SimulationState Update(StepTimer const& timer, const SimulationState& state);
+      void Render(const SimulationState& state);
+      void BuildFrameGraph();
+      void Clear(CommandList& commandList, Texture& renderTarget, Texture& depth);
+      void Present();
+      void MoveToNextFrame();
+      void RecordFrameTiming();
+   };
+}
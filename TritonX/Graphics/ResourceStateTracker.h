@@ -0,0 +1,110 @@
+//
+// ResourceStateTracker.h - Per command list texture states, resolved against the queue at submit
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics/Device.h"
+
+namespace TX::Graphics {
+
+   // Lets recording code say which state a texture has to be in instead of writing transitions by
+   // hand. Lists are recorded in parallel, so a list cannot know what state the lists submitted
+   // before it leave a texture in. The first state a list requires for a texture is therefore
+   // only remembered, and Resolve turns it into a barrier at submit time against the texture's
+   // committed state. Later changes inside the list are known and become barriers straight away,
+   // queued until the next Flush so that they go out as one batch. Transitions to the state a
+   // texture is already in are dropped, and several changes to one texture between flushes merge
+   // into a single transition, or none if they end where they started.
+   //
+   // A leading tracker belongs to a list that is submitted ahead of everything recorded with it.
+   // Nothing can change the committed states before that list runs, so it transitions out of
+   // them in place, like any later change, and leaves Resolve nothing to add in front of it.
+   //
+   //    states.Require(target, ResourceState::RenderTarget);
+   //    states.Flush(commandList);
+   //    commandList.ClearRenderTarget(target, color);
+   class ResourceStateTracker {
+    public:
+      // texture must be in state for the next command recorded after Flush.
+      void Require(Texture& texture, ResourceState state) {
+         const auto [it, inserted] =
+             indices.try_emplace(&texture, static_cast<uint32_t>(entries.size()));
+         if (inserted) {
+            const ResourceState entryState = leading ? texture.GetCommittedState() : state;
+            entries.push_back({&texture, entryState, entryState, NoBatch, 0});
+         }
+
+         auto& entry = entries[it->second];
+         if (entry.current == state) {
+            return;
+         }
+         if (entry.pendingBatch == batch) {
+            pending[entry.pendingIndex].after = state;
+         } else {
+            entry.pendingBatch = batch;
+            entry.pendingIndex = static_cast<uint32_t>(pending.size());
+            pending.push_back({&texture, entry.current, state});
+         }
+         entry.current = state;
+      }
+
+      // Records every transition required since the last flush in one batch. Call before any
+      // command that depends on the required states.
+      void Flush(CommandList& commandList) {
+         std::erase_if(pending, [](const TextureBarrier& barrier) {
+            return barrier.before == barrier.after;
+         });
+         commandList.Barriers(pending);
+         pending.clear();
+         batch++;
+      }
+
+      // Submit side, called in submission order once the list is complete. Appends to barriers
+      // whatever must run before the list to bring textures from their committed state into the
+      // state the list first required, then commits the states the list leaves them in.
+      void Resolve(std::vector<TextureBarrier>& barriers) {
+         for (const auto& entry : entries) {
+            const ResourceState committed = entry.texture->GetCommittedState();
+            if (committed != entry.initial) {
+               barriers.push_back({entry.texture, committed, entry.initial});
+            }
+            entry.texture->SetCommittedState(entry.current);
+         }
+      }
+
+      // Forgets everything, keeping capacity. Any transitions not yet flushed are dropped. Until
+      // the next Reset the tracker is leading if isLeading is set; see above.
+      void Reset(bool isLeading = false) noexcept {
+         indices.clear();
+         entries.clear();
+         pending.clear();
+         batch = 0;
+         leading = isLeading;
+      }
+
+    private:
+      static constexpr uint32_t NoBatch = UINT32_MAX;
+
+      struct Entry {
+         Texture* texture;
+         // First state required in this list, and the state the list has moved it to since.
+         ResourceState initial;
+         ResourceState current;
+         // Where this texture's unflushed transition is, if pendingBatch is the current batch.
+         uint32_t pendingBatch;
+         uint32_t pendingIndex;
+      };
+
+      std::unordered_map<Texture*, uint32_t> indices;
+      std::vector<Entry> entries;
+      std::vector<TextureBarrier> pending;
+      uint32_t batch{0};
+      bool leading{false};
+   };
+}
@@ -0,0 +1,201 @@
+//
+// Timeline.h - Tracks a queue's fence and lets any thread poll, wait or be called back on it
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Graphics/Device.h"
+
+namespace TX::Graphics {
+
+   // Owns the sequence of values signalled on one queue. A dispatcher thread is the only thing
+   // that ever blocks on the queue's fence; everyone else polls, waits on a condition variable
+   // with or without a timeout, or registers a callback that the dispatcher runs once the GPU gets
+   // there. Signal is meant for the one thread that submits to the queue; everything else may be
+   // called from any thread.
+   class Timeline {
+    public:
+      using Callback = std::function<void()>;
+
+      explicit Timeline(Queue& queue) :
+          queue(queue), issuedValue(queue.GetCompletedValue()),
+          completedValue(queue.GetCompletedValue()), dispatcher([this] { Run(); }) {
+      }
+
+      // Pending callbacks whose value the GPU has not reached are dropped. Call WaitForIdle first
+      // if they must run.
+      ~Timeline() {
+         {
+            std::lock_guard lock(mutex);
+            stopping = true;
+         }
+         changed.notify_all();
+         dispatcher.join();
+      }
+
+      Timeline(const Timeline&) = delete;
+      Timeline& operator=(const Timeline&) = delete;
+
+      // Signals the next value on the queue behind everything submitted so far and returns it.
+      uint64_t Signal() {
+         const uint64_t value = issuedValue.load(std::memory_order_relaxed) + 1;
+         queue.Signal(value);
+         {
+            std::lock_guard lock(mutex);
+            issuedValue.store(value, std::memory_order_release);
+         }
+         changed.notify_all();
+         return value;
+      }
+
+      // The value the next Signal will issue. Work submitted now completes when it is reached.
+      [[nodiscard]] uint64_t GetNextValue() const noexcept {
+         return issuedValue.load(std::memory_order_acquire) + 1;
+      }
+
+      [[nodiscard]] uint64_t GetIssuedValue() const noexcept {
+         return issuedValue.load(std::memory_order_acquire);
+      }
+
+      // Polls the fence without blocking.
+      [[nodiscard]] uint64_t GetCompletedValue() const {
+         return std::max(completedValue.load(std::memory_order_acquire), queue.GetCompletedValue());
+      }
+
+      [[nodiscard]] bool IsComplete(uint64_t value) const {
+         return completedValue.load(std::memory_order_acquire) >= value ||
+                queue.GetCompletedValue() >= value;
+      }
+
+      void Wait(uint64_t value) {
+         if (IsComplete(value)) {
+            return;
+         }
+         std::unique_lock lock(mutex);
+         CheckIssued(value);
+         changed.wait(lock, [&] { return Reached(value); });
+      }
+
+      // Returns false if value was not reached within timeout.
+      bool WaitFor(uint64_t value, std::chrono::nanoseconds timeout) {
+         if (IsComplete(value)) {
+            return true;
+         }
+         std::unique_lock lock(mutex);
+         CheckIssued(value);
+         return changed.wait_for(lock, timeout, [&] { return Reached(value); }) &&
+                completedValue.load(std::memory_order_relaxed) >= value;
+      }
+
+      // Signals and waits for everything submitted so far.
+      void WaitForIdle() {
+         Wait(Signal());
+      }
+
+      // Runs callback on the dispatcher thread once the GPU reaches value, even if it already has.
+      // Callbacks for the same value run in registration order.
+      void OnComplete(uint64_t value, Callback callback) {
+         {
+            std::lock_guard lock(mutex);
+            callbacks.push({value, nextCallbackOrder++, std::move(callback)});
+         }
+         changed.notify_all();
+      }
+
+    private:
+      // How long the dispatcher blocks on the fence before checking whether it should stop.
+      static constexpr std::chrono::milliseconds PollInterval{100};
+
+      struct PendingCallback {
+         uint64_t value;
+         uint64_t order;
+         Callback callback;
+
+         bool operator>(const PendingCallback& other) const noexcept {
+            return value != other.value ? value > other.value : order > other.order;
+         }
+      };
+
+      Queue& queue;
+
+      mutable std::mutex mutex;
+      std::condition_variable changed;
+      std::atomic<uint64_t> issuedValue;
+      std::atomic<uint64_t> completedValue;
+      std::priority_queue<PendingCallback, std::vector<PendingCallback>, std::greater<>>
+          callbacks;
+      uint64_t nextCallbackOrder{0};
+      bool stopping{false};
+
+      std::thread dispatcher;
+
+      void CheckIssued(uint64_t value) const {
+         if (value > issuedValue.load(std::memory_order_relaxed)) {
+            throw std::logic_error("Timeline wait on a value that has not been signalled");
+         }
+      }
+
+      // Waiters give up when the dispatcher stops so none are stranded by destruction.
+      bool Reached(uint64_t value) const noexcept {
+         return stopping || completedValue.load(std::memory_order_relaxed) >= value;
+      }
+
+      bool HasReadyCallback() const noexcept {
+         return !callbacks.empty() &&
+                callbacks.top().value <= completedValue.load(std::memory_order_relaxed);
+      }
+
+      void Run() {
+         std::unique_lock lock(mutex);
+         while (true) {
+            while (HasReadyCallback()) {
+               // top() is const, but the entry is popped straight away and ordering never looks at
+               // the callback, so moving it out is safe.
+               auto& next = const_cast<PendingCallback&>(callbacks.top());
+               Callback callback = std::move(next.callback);
+               callbacks.pop();
+               lock.unlock();
+               callback();
+               lock.lock();
+            }
+
+            if (stopping) {
+               return;
+            }
+
+            const uint64_t completed = completedValue.load(std::memory_order_relaxed);
+            if (completed >= issuedValue.load(std::memory_order_relaxed)) {
+               changed.wait(lock, [&] {
+                  return stopping || issuedValue.load(std::memory_order_relaxed) > completed ||
+                         HasReadyCallback();
+               });
+               continue;
+            }
+
+            // Values complete in order, so waiting for the next one reports each as soon as the
+            // GPU gets there.
+            lock.unlock();
+            queue.Wait(completed + 1, PollInterval);
+            const uint64_t reached = queue.GetCompletedValue();
+            lock.lock();
+
+            if (reached > completed) {
+               completedValue.store(reached, std::memory_order_release);
+               changed.notify_all();
+            }
+         }
+      }
+   };
+}
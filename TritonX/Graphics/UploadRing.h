@@ -0,0 +1,198 @@
+//
+// UploadRing.h - Persistently mapped per frame scratch memory for data the GPU reads once
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Graphics/Device.h"
+#include "Graphics/Timeline.h"
+
+namespace TX::Graphics {
+
+   struct UploadAllocation {
+      std::byte* data;
+      uint64_t gpuAddress;
+      uint64_t size;
+   };
+
+   // Streams constants, vertices and instance data that only live for one frame. One upload
+   // buffer is split into a partition per frame, and each frame bumps a pointer through its own
+   // partition. EndFrame tags the partition with the fence value that follows the frame's work,
+   // and BeginFrame only starts reusing it once the GPU has passed that value.
+   //
+   // Allocate on the ring takes one compare and swap and may be called from any thread. Threads
+   // making many small allocations should use a Context. A Context claims a chunk of the
+   // partition at a time and bumps through it without any atomics.
+   //
+   //    ring.BeginFrame();
+   //    UploadRing::Context upload(ring); // one per recording thread
+   //    auto constants = upload.Allocate(sizeof(Constants), UploadRing::ConstantBufferAlignment);
+   //    std::memcpy(constants.data, &frameConstants, sizeof(Constants));
+   //    ...
+   //    ring.EndFrame(timeline.Signal());
+   class UploadRing {
+    public:
+      // D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT.
+      static constexpr uint64_t ConstantBufferAlignment = 256;
+      // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, for texture data copied out of the ring.
+      static constexpr uint64_t TextureDataAlignment = 512;
+      // Partitions and chunks start at this alignment, so anything up to it can be served.
+      static constexpr uint64_t MaxAlignment = TextureDataAlignment;
+      static constexpr uint64_t DefaultChunkSize = 64 * 1024;
+
+      // A thread's allocations from the ring. Must not be shared between threads. Chunks from
+      // an earlier frame are dropped on the first allocation after BeginFrame.
+      class Context {
+       public:
+         explicit Context(UploadRing& ring) noexcept : ring(ring), frame(0), offset(0), end(0) {
+         }
+
+         // alignment must be a power of two no greater than MaxAlignment. Throws
+         // std::length_error if the frame's partition is exhausted.
+         UploadAllocation Allocate(uint64_t size, uint64_t alignment) {
+            CheckAlignment(alignment);
+            const uint64_t currentFrame = ring.frame.load(std::memory_order_acquire);
+            uint64_t begin = AlignUp(offset, alignment);
+            if (currentFrame != frame || begin + size > end) {
+               // Big allocations would waste most of a chunk, so they go to the ring.
+               if (size > ring.chunkSize / 4) {
+                  return ring.Allocate(size, alignment);
+               }
+               // Near the end of the partition, take whatever is left as long as this fits.
+               const Reservation chunk = ring.Reserve(ring.chunkSize, size, MaxAlignment);
+               offset = chunk.offset;
+               end = chunk.offset + chunk.size;
+               frame = currentFrame;
+               begin = offset;
+            }
+            offset = begin + size;
+            return ring.At(begin, size);
+         }
+
+       private:
+         UploadRing& ring;
+         uint64_t frame;
+         // Offsets into the ring's buffer of the rest of this thread's chunk.
+         uint64_t offset;
+         uint64_t end;
+      };
+
+      // Maps partitionCount partitions of partitionSize bytes each. partitionSize is rounded up
+      // to MaxAlignment.
+      UploadRing(Device& device,
+                 Timeline& timeline,
+                 uint64_t partitionSize,
+                 uint32_t partitionCount,
+                 uint64_t chunkSize = DefaultChunkSize) :
+          timeline(timeline), partitionSize(AlignUp(partitionSize, MaxAlignment)),
+          chunkSize(AlignUp(chunkSize, MaxAlignment)), partitionFences(partitionCount, 0),
+          partition(partitionCount - 1), partitionBase(0), frame(0), head(0) {
+         if (partitionCount == 0 || this->chunkSize > this->partitionSize) {
+            throw std::invalid_argument("UploadRing needs a partition at least one chunk large");
+         }
+         buffer = device.CreateUploadBuffer(this->partitionSize * partitionCount);
+         mappedData = buffer->GetMappedData();
+         gpuAddress = buffer->GetGpuAddress();
+      }
+
+      UploadRing(const UploadRing&) = delete;
+      UploadRing& operator=(const UploadRing&) = delete;
+
+      // Moves on to the next partition, waiting for the GPU to finish the frame that last used
+      // it. The frame before must have ended, and no thread may still be allocating.
+      void BeginFrame() {
+         partition = (partition + 1) % static_cast<uint32_t>(partitionFences.size());
+         timeline.Wait(partitionFences[partition]);
+         partitionBase = uint64_t{partition} * partitionSize;
+         head.store(0, std::memory_order_relaxed);
+         frame.fetch_add(1, std::memory_order_release);
+      }
+
+      // fenceValue is signalled once the GPU is done with everything allocated this frame.
+      void EndFrame(uint64_t fenceValue) noexcept {
+         partitionFences[partition] = fenceValue;
+      }
+
+      // See Context::Allocate. Safe to call from any thread.
+      UploadAllocation Allocate(uint64_t size, uint64_t alignment) {
+         return At(Reserve(size, alignment), size);
+      }
+
+      // Bytes handed out this frame, including chunks claimed by contexts but not used yet.
+      [[nodiscard]] uint64_t GetFrameUsage() const noexcept {
+         return head.load(std::memory_order_relaxed);
+      }
+
+      [[nodiscard]] uint64_t GetPartitionSize() const noexcept {
+         return partitionSize;
+      }
+
+    private:
+      Timeline& timeline;
+      std::unique_ptr<UploadBuffer> buffer;
+      std::byte* mappedData{nullptr};
+      uint64_t gpuAddress{0};
+      uint64_t partitionSize;
+      uint64_t chunkSize;
+
+      // Written only by BeginFrame and EndFrame.
+      std::vector<uint64_t> partitionFences;
+      uint32_t partition;
+      uint64_t partitionBase;
+      // Counts frames, so that contexts can tell their chunk belongs to an earlier one.
+      std::atomic<uint64_t> frame;
+
+      // Every allocating thread hits this, so keep it off the line the fields above share.
+      alignas(64) std::atomic<uint64_t> head;
+
+      static constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept {
+         return (value + alignment - 1) & ~(alignment - 1);
+      }
+
+      static void CheckAlignment(uint64_t alignment) {
+         if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > MaxAlignment) {
+            throw std::invalid_argument("UploadRing alignment must be a power of two up to 512");
+         }
+      }
+
+      struct Reservation {
+         uint64_t offset;
+         uint64_t size;
+      };
+
+      // Claims size bytes of the current partition and returns their offset in the buffer.
+      uint64_t Reserve(uint64_t size, uint64_t alignment) {
+         return Reserve(size, size, alignment).offset;
+      }
+
+      // Claims up to size bytes of the current partition, or what is left of it if that is less
+      // but still at least minSize, and returns their offset in the buffer and length.
+      Reservation Reserve(uint64_t size, uint64_t minSize, uint64_t alignment) {
+         CheckAlignment(alignment);
+         uint64_t current = head.load(std::memory_order_relaxed);
+         uint64_t begin;
+         uint64_t claimed;
+         do {
+            begin = AlignUp(current, alignment);
+            if (begin + minSize > partitionSize) {
+               throw std::length_error("UploadRing frame partition exhausted");
+            }
+            claimed = std::min(size, partitionSize - begin);
+         } while (
+             !head.compare_exchange_weak(current, begin + claimed, std::memory_order_relaxed));
+         return {partitionBase + begin, claimed};
+      }
+
+      [[nodiscard]] UploadAllocation At(uint64_t offset, uint64_t size) const noexcept {
+         return {mappedData + offset, gpuAddress + offset, size};
+      }
+   };
+}
@@ -1,102 +1,176 @@
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <type_traits>
 #include <ctime>
 #include <iomanip>
 #include <string_view>
 
+#include "System/LogFormat.h"
+#include "System/LogPipeline.h"
+#include "System/LogRate.h"
+#include "System/LogRecord.h"
+
+// Compile time floor for log levels, as the integer value of a Log::Level. Anything below it is
+// removed from the build when logged through the TX_LOG_* macros. Defaults to everything in debug
+// builds and Info and above in release builds. Individual categories can be raised or lowered
+// with TX_LOG_MIN_LEVEL_<CATEGORY>.
+#ifndef TX_LOG_MIN_LEVEL
+#if defined(NDEBUG)
+#define TX_LOG_MIN_LEVEL 2
+#else
+#define TX_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+#ifndef TX_LOG_MIN_LEVEL_GENERAL
+#define TX_LOG_MIN_LEVEL_GENERAL TX_LOG_MIN_LEVEL
+#endif
+#ifndef TX_LOG_MIN_LEVEL_GRAPHICS
+#define TX_LOG_MIN_LEVEL_GRAPHICS TX_LOG_MIN_LEVEL
+#endif
+#ifndef TX_LOG_MIN_LEVEL_TIMING
+#define TX_LOG_MIN_LEVEL_TIMING TX_LOG_MIN_LEVEL
+#endif
+
 namespace Log {
 
-   enum class Level {
-      Trace = 0,
-      Debug,
-      Info,
-      Warn,
-      Error
+   enum class Category {
+      General,
+      Graphics,
+      Timing
    };
 
+   template <Category C>
+   inline constexpr Level CompiledMinLevel = Level::Trace;
+   template <>
+   inline constexpr Level CompiledMinLevel<Category::General> = Level{TX_LOG_MIN_LEVEL_GENERAL};
+   template <>
+   inline constexpr Level CompiledMinLevel<Category::Graphics> = Level{TX_LOG_MIN_LEVEL_GRAPHICS};
+   template <>
+   inline constexpr Level CompiledMinLevel<Category::Timing> = Level{TX_LOG_MIN_LEVEL_TIMING};
+
+   template <Level L, Category C>
+   inline constexpr bool IsCompiledIn = L >= CompiledMinLevel<C>;
+
    class LogManager {
     public:
       static LogManager& getInstance() {
-         static LogManager instance;
          return instance;
       }
       void setMinLevel(Level newLevel) {
-         level = newLevel;
+         level.store(newLevel, std::memory_order_relaxed);
       }
 
       [[nodiscard]] Level getLevel() const {
-         return level;
+         return level.load(std::memory_order_relaxed);
       }
 
     private:
       LogManager() = default;
-      Level level;
+      std::atomic<Level> level{Level::Trace};
+
+      // Namespace scope rather than function local so level checks skip the static init guard.
+      static LogManager instance;
    };
 
-   class Logger {
-    public:
-      Logger(Level level) : level(level) {
+   inline LogManager LogManager::instance;
+
+   // True if a message at L in C survives both the compile time floor and the runtime level.
+   template <Level L, Category C = Category::General>
+   [[nodiscard]] inline bool ShouldLog() noexcept {
+      if constexpr (!IsCompiledIn<L, C>) {
+         return false;
+      } else {
+         return LogManager::getInstance().getLevel() <= L;
       }
+   }
 
-      [[nodiscard]] const std::wstring_view header() const {
+   // Defers building a value until the message is known to be emitted:
+   //    Log::debug << Log::Lazy{[&] { return Describe(thing); }} << std::endl;
+   template <typename F>
+   struct Lazy {
+      F producer;
+   };
 
-         if (level == Level::Trace) {
-            return L"Trace ";
-         }
-         if (level == Level::Debug) {
-            return L"Debug ";
-         }
-         if (level == Level::Info) {
-            return L"Info  ";
-         }
-         if (level == Level::Warn) {
-            return L"Warn  ";
-         }
-         if (level == Level::Error) {
-            return L"Error ";
-         }
-         return L"Unknown";
+   template <typename F>
+   Lazy(F) -> Lazy<F>;
+
+   template <typename T>
+   inline constexpr bool IsLazy = false;
+   template <typename F>
+   inline constexpr bool IsLazy<Lazy<F>> = true;
+
+   // Assembles a line from streamed values and hands it to the Pipeline on std::endl. Nothing is
+   // written to a sink on the calling thread. Compiled out levels reduce every operator to a
+   // return; use the TX_LOG_* macros to also skip evaluating the streamed expressions.
+   // The line being built lives in thread local storage, so any number of threads can stream
+   // into the same logger without locks and each line reaches the queue as one record. Values are
+   // written as UTF-8 straight into a fixed size buffer, see AppendValue for what is supported
+   // without allocating.
+   template <Level L, Category C = Category::General>
+   class Logger {
+    public:
+      static constexpr Level level = L;
+      static constexpr Category category = C;
+
+      [[nodiscard]] const std::string_view header() const {
+         return LevelName(L);
       }
 
       template <typename T>
       Logger& operator<<(const T& value) {
-         if (LogManager::getInstance().getLevel() > level) {
+         if (!ShouldLog<L, C>()) {
             return *this;
          }
-         if (isNextBegin) {
-            std::wstringstream wss{};
-            wss << header().data() << value << std::endl;
-            OutputDebugString(wss.str().c_str());
+         auto& line = CurrentLine();
+         if (line.isNextBegin) {
+            line.text.Clear();
+         }
+         if constexpr (IsLazy<T>) {
+            AppendValue(line.text, value.producer());
          } else {
-            OutputDebugString(value);
+            AppendValue(line.text, value);
          }
-         isNextBegin = false;
+         line.isNextBegin = false;
          return *this;
       }
 
-      Logger& operator<<(decltype(std::endl<char, std::char_traits<char>>)& manip) {
-         if (LogManager::getInstance().getLevel() > level) {
+      Logger& operator<<(decltype(std::endl<char, std::char_traits<char>>)&) {
+         if (!ShouldLog<L, C>()) {
             return *this;
          }
-         isNextBegin = true;
-         std::cout << manip;
+         auto& line = CurrentLine();
+         GetPipeline().Submit(L, line.text.View());
+         line.isNextBegin = true;
          return *this;
       }
 
     private:
-      Level level;
-      bool isNextBegin{true};
+      struct Line {
+         bool isNextBegin{true};
+         FixedString<Record::MaxLength> text;
+      };
+
+      // One partially built line per thread for each level and category.
+      static Line& CurrentLine() {
+         thread_local Line line;
+         return line;
+      }
    };
 
-   inline Logger trace = Logger{Level::Trace};
-   inline Logger debug = Logger{Level::Debug};
-   inline Logger info = Logger{Level::Info};
-   inline Logger warn = Logger{Level::Warn};
-   inline Logger error = Logger{Level::Error};
+   template <Level L, Category C = Category::General>
+   inline Logger<L, C> logger;
 
-      void LastError() {
+   inline auto& trace = logger<Level::Trace>;
+   inline auto& debug = logger<Level::Debug>;
+   inline auto& info = logger<Level::Info>;
+   inline auto& warn = logger<Level::Warn>;
+   inline auto& error = logger<Level::Error>;
+
+#if defined(_WIN32)
+   inline void LastError() {
       DWORD errCode = GetLastError();
       LPWSTR errMsg = nullptr;
       FormatMessageW(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER,
@@ -110,4 +184,44 @@ namespace Log {
       Log::error << errMsg << std::endl;
       LocalFree(errMsg);
    }
-}
\ No newline at end of file
+#endif
+}
+
+// Streams into the logger for the given level and category only if the message would be emitted.
+// Below the compile time floor the whole statement, including the streamed expressions, is
+// discarded; below the runtime level the expressions are never evaluated.
+//    TX_LOG(Debug, Graphics) << L"Resized to " << width << L"x" << height << std::endl;
+#define TX_LOG(level, category)                                                                    \
+   if (!::Log::ShouldLog<::Log::Level::level, ::Log::Category::category>()) {                      \
+   } else                                                                                          \
+      ::Log::logger<::Log::Level::level, ::Log::Category::category>
+
+#define TX_LOG_TRACE TX_LOG(Trace, General)
+#define TX_LOG_DEBUG TX_LOG(Debug, General)
+#define TX_LOG_INFO TX_LOG(Info, General)
+#define TX_LOG_WARN TX_LOG(Warn, General)
+#define TX_LOG_ERROR TX_LOG(Error, General)
+
+// Like TX_LOG, but lets at most maxPerSecond messages per second through from this call site and
+// prefixes the next emitted message with how many were suppressed in between.
+//    TX_LOG_RATE_LIMITED(Debug, Graphics, 2) << L"Waited on fence " << value << std::endl;
+#define TX_LOG_RATE_LIMITED(level, category, maxPerSecond)                                         \
+   if (uint64_t txLogSuppressed = 0;                                                               \
+       !::Log::ShouldLog<::Log::Level::level, ::Log::Category::category>() ||                      \
+       ![]() -> ::Log::RateLimiter& {                                                              \
+          static ::Log::RateLimiter site;                                                          \
+          return site;                                                                             \
+       }().Allow(maxPerSecond, txLogSuppressed)) {                                                 \
+   } else                                                                                          \
+      ::Log::logger<::Log::Level::level, ::Log::Category::category>                                \
+          << ::Log::Suppressed{txLogSuppressed}
+
+// Like TX_LOG, but only emits every nth message from this call site, starting with the first.
+#define TX_LOG_EVERY_N(level, category, n)                                                         \
+   if (!::Log::ShouldLog<::Log::Level::level, ::Log::Category::category>() ||                      \
+       ![]() -> ::Log::Sampler& {                                                                  \
+          static ::Log::Sampler site;                                                              \
+          return site;                                                                             \
+       }().Allow(n)) {                                                                             \
+   } else                                                                                          \
+      ::Log::logger<::Log::Level::level, ::Log::Category::category>
@@ -7,26 +7,38 @@
 #include <cmath>
 #include <cstdint>
 #include <exception>
-#include <profileapi.h>
+
+#include "Clock.h"
+#include "FrameStats.h"
 
 namespace TX {
    // Helper class for animation and simulation timing.
-   class StepTimer {
+   // TClock is a clock policy (see Clock.h) that supplies the raw time source.
+   template <typename TClock = DefaultClock>
+   class BasicStepTimer {
     public:
-      StepTimer() noexcept(false) :
-          m_elapsedTicks(0), m_totalTicks(0), m_leftOverTicks(0), m_frameCount(0),
-          m_framesPerSecond(0), m_framesThisSecond(0), m_qpcSecondCounter(0),
-          m_isFixedTimeStep(false), m_targetElapsedTicks(TicksPerSecond / 60) {
-         if (!QueryPerformanceFrequency(&m_qpcFrequency)) {
+      explicit BasicStepTimer(TClock clock = TClock{}) noexcept(false) :
+          m_clock(clock), m_elapsedTicks(0), m_totalTicks(0), m_leftOverTicks(0),
+          m_frameCount(0), m_framesPerSecond(0), m_framesThisSecond(0), m_clockSecondCounter(0),
+          m_isFixedTimeStep(false), m_targetElapsedTicks(TicksPerSecond / 60),
+          m_maxUpdatesPerTick(0), m_droppedTicks(0), m_frameStats(TicksPerSecond) {
+         m_clockFrequency = m_clock.Frequency();
+         if (m_clockFrequency == 0) {
             throw std::exception();
          }
 
-         if (!QueryPerformanceCounter(&m_qpcLastTime)) {
-            throw std::exception();
-         }
+         m_clockLastTime = m_clock.Now();
 
          // Initialize max delta to 1/10 of a second.
-         m_qpcMaxDelta = static_cast<uint64_t>(m_qpcFrequency.QuadPart / 10);
+         m_clockMaxDelta = m_clockFrequency / 10;
+      }
+
+      // Access the underlying time source, e.g. to advance a ManualClock.
+      TClock& GetClock() noexcept {
+         return m_clock;
+      }
+      const TClock& GetClock() const noexcept {
+         return m_clock;
       }
 
       // Get elapsed time since the previous Update call.
@@ -55,11 +67,53 @@ namespace TX {
          return m_framesPerSecond;
       }
 
+      // Get the rolling frame time distribution. ReadSnapshot() on the result may be called from
+      // one thread other than the one calling Tick().
+      FrameStats& GetFrameStats() noexcept {
+         return m_frameStats;
+      }
+
       // Set whether to use fixed or variable timestep mode.
       void SetFixedTimeStep(bool isFixedTimestep) noexcept {
          m_isFixedTimeStep = isFixedTimestep;
       }
 
+      // Limit how many fixed timestep Updates a single Tick may run. Whole steps beyond the limit
+      // are discarded rather than carried over, so one slow frame cannot snowball into ever longer
+      // catch-up bursts. Zero means unlimited.
+      void SetMaxUpdatesPerTick(uint32_t maxUpdates) noexcept {
+         m_maxUpdatesPerTick = maxUpdates;
+      }
+
+      // Get total simulation time discarded by the max delta clamp or the max updates per tick
+      // limit since the start of the program.
+      uint64_t GetDroppedTicks() const noexcept {
+         return m_droppedTicks;
+      }
+      double GetDroppedSeconds() const noexcept {
+         return TicksToSeconds(m_droppedTicks);
+      }
+
+      // Get how far the clock has advanced past the last fixed Update, as a fraction of the target
+      // step in [0, 1). Render with this to blend the previous and current simulation states.
+      // Always 1 in variable timestep mode, where the last Update is exactly current.
+      double GetInterpolationAlpha() const noexcept {
+         if (!m_isFixedTimeStep || m_targetElapsedTicks == 0) {
+            return 1.0;
+         }
+         return static_cast<double>(m_leftOverTicks) / static_cast<double>(m_targetElapsedTicks);
+      }
+
+      // Get time accumulated towards the next fixed timestep Update.
+      uint64_t GetLeftOverTicks() const noexcept {
+         return m_leftOverTicks;
+      }
+
+      // Get the fixed timestep length.
+      uint64_t GetTargetElapsedTicks() const noexcept {
+         return m_targetElapsedTicks;
+      }
+
       // Set how often to call Update when in fixed timestep mode.
       void SetTargetElapsedTicks(uint64_t targetElapsed) noexcept {
          m_targetElapsedTicks = targetElapsed;
@@ -83,40 +137,41 @@ namespace TX {
       // Update calls.
 
       void ResetElapsedTime() {
-         if (!QueryPerformanceCounter(&m_qpcLastTime)) {
-            throw std::exception();
-         }
+         m_clockLastTime = m_clock.Now();
 
          m_leftOverTicks = 0;
          m_framesPerSecond = 0;
          m_framesThisSecond = 0;
-         m_qpcSecondCounter = 0;
+         m_clockSecondCounter = 0;
+         m_frameStats.Reset();
       }
 
       // Update timer state, calling the specified Update function the appropriate number of times.
       template <typename TUpdate>
       void Tick(const TUpdate& update) {
          // Query the current time.
-         LARGE_INTEGER currentTime;
+         const uint64_t currentTime = m_clock.Now();
 
-         if (!QueryPerformanceCounter(&currentTime)) {
-            throw std::exception();
-         }
+         uint64_t timeDelta = currentTime - m_clockLastTime;
 
-         uint64_t timeDelta = static_cast<uint64_t>(currentTime.QuadPart - m_qpcLastTime.QuadPart);
+         m_clockLastTime = currentTime;
+         m_clockSecondCounter += timeDelta;
 
-         m_qpcLastTime = currentTime;
-         m_qpcSecondCounter += timeDelta;
+         // Unclamped delta for telemetry, split so large debugger pauses cannot overflow.
+         const uint64_t rawTicks = timeDelta / m_clockFrequency * TicksPerSecond +
+                                   timeDelta % m_clockFrequency * TicksPerSecond / m_clockFrequency;
 
          // Clamp excessively large time deltas (e.g. after paused in the debugger).
-         if (timeDelta > m_qpcMaxDelta) {
-            timeDelta = m_qpcMaxDelta;
+         if (timeDelta > m_clockMaxDelta) {
+            timeDelta = m_clockMaxDelta;
          }
 
-         // Convert QPC units into a canonical tick format. This cannot overflow due to the previous
-         // clamp.
+         // Convert clock units into a canonical tick format. This cannot overflow due to the
+         // previous clamp.
          timeDelta *= TicksPerSecond;
-         timeDelta /= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+         timeDelta /= m_clockFrequency;
+
+         m_droppedTicks += rawTicks - timeDelta;
 
          const uint32_t lastFrameCount = m_frameCount;
 
@@ -138,11 +193,22 @@ namespace TX {
 
             m_leftOverTicks += timeDelta;
 
+            uint32_t updates = 0;
             while (m_leftOverTicks >= m_targetElapsedTicks) {
+               if (m_maxUpdatesPerTick != 0 && updates == m_maxUpdatesPerTick) {
+                  // Out of budget, drop the remaining whole steps but keep the fraction so the
+                  // interpolation alpha stays continuous.
+                  const uint64_t remainder = m_leftOverTicks % m_targetElapsedTicks;
+                  m_droppedTicks += m_leftOverTicks - remainder;
+                  m_leftOverTicks = remainder;
+                  break;
+               }
+
                m_elapsedTicks = m_targetElapsedTicks;
                m_totalTicks += m_targetElapsedTicks;
                m_leftOverTicks -= m_targetElapsedTicks;
                m_frameCount++;
+               updates++;
 
                update();
             }
@@ -161,18 +227,21 @@ namespace TX {
             m_framesThisSecond++;
          }
 
-         if (m_qpcSecondCounter >= static_cast<uint64_t>(m_qpcFrequency.QuadPart)) {
+         m_frameStats.Record(rawTicks, m_frameCount - lastFrameCount);
+
+         if (m_clockSecondCounter >= m_clockFrequency) {
             m_framesPerSecond = m_framesThisSecond;
             m_framesThisSecond = 0;
-            m_qpcSecondCounter %= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+            m_clockSecondCounter %= m_clockFrequency;
          }
       }
 
     private:
-      // Source timing data uses QPC units.
-      LARGE_INTEGER m_qpcFrequency;
-      LARGE_INTEGER m_qpcLastTime;
-      uint64_t m_qpcMaxDelta;
+      // Source timing data uses the clock policy's native units.
+      TClock m_clock;
+      uint64_t m_clockFrequency;
+      uint64_t m_clockLastTime;
+      uint64_t m_clockMaxDelta;
 
       // Derived timing data uses a canonical tick format.
       uint64_t m_elapsedTicks;
@@ -183,10 +252,17 @@ namespace TX {
       uint32_t m_frameCount;
       uint32_t m_framesPerSecond;
       uint32_t m_framesThisSecond;
-      uint64_t m_qpcSecondCounter;
+      uint64_t m_clockSecondCounter;
 
       // Members for configuring fixed timestep mode.
       bool m_isFixedTimeStep;
       uint64_t m_targetElapsedTicks;
+      uint32_t m_maxUpdatesPerTick;
+      uint64_t m_droppedTicks;
+
+      // Rolling distribution of tick deltas and updates per tick.
+      FrameStats m_frameStats;
    };
+
+   using StepTimer = BasicStepTimer<>;
 }
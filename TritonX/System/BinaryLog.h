@@ -0,0 +1,390 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+#include "System/BinaryLogFormat.h"
+#include "System/LogPipeline.h"
+#include "System/LogRecord.h"
+
+namespace Log::Binary {
+
+   // Per call site state. Constant initialized, so a function local static of this type costs no
+   // initialization guard. The descriptor id is assigned the first time the site logs to a file,
+   // and kept along with the generation of the Open it was written for, in the upper 32 bits, so
+   // that the site writes its descriptor again into a log that has been reopened since.
+   struct CallSite {
+      const char* file;
+      uint32_t line;
+      std::atomic<uint64_t> registration{0};
+   };
+
+   namespace Detail {
+      // Every supported argument is normalized to one of these before encoding.
+      inline bool ToArg(bool value) noexcept {
+         return value;
+      }
+      inline std::string_view ToArg(const char* value) noexcept {
+         return value ? std::string_view{value} : std::string_view{"(null)"};
+      }
+      inline std::string_view ToArg(std::string_view value) noexcept {
+         return value;
+      }
+      inline std::string_view ToArg(const std::string& value) noexcept {
+         return value;
+      }
+      template <typename T>
+      auto ToArg(const T& value) noexcept {
+         if constexpr (std::is_enum_v<T>) {
+            return ToArg(static_cast<std::underlying_type_t<T>>(value));
+         } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            return static_cast<int64_t>(value);
+         } else if constexpr (std::is_integral_v<T>) {
+            return static_cast<uint64_t>(value);
+         } else if constexpr (std::is_floating_point_v<T>) {
+            return static_cast<double>(value);
+         } else if constexpr (std::is_pointer_v<T>) {
+            return static_cast<const void*>(value);
+         } else {
+            static_assert(std::is_pointer_v<T>, "Type cannot be written to the binary log");
+         }
+      }
+
+      template <typename T>
+      constexpr ArgType TypeOf() noexcept {
+         if constexpr (std::is_same_v<T, bool>) {
+            return ArgType::Bool;
+         } else if constexpr (std::is_same_v<T, int64_t>) {
+            return ArgType::Int64;
+         } else if constexpr (std::is_same_v<T, uint64_t>) {
+            return ArgType::UInt64;
+         } else if constexpr (std::is_same_v<T, double>) {
+            return ArgType::Double;
+         } else if constexpr (std::is_same_v<T, const void*>) {
+            return ArgType::Pointer;
+         } else {
+            static_assert(std::is_same_v<T, std::string_view>);
+            return ArgType::String;
+         }
+      }
+
+      template <typename T>
+      size_t EncodedSize(const T& value) noexcept {
+         if constexpr (std::is_same_v<T, std::string_view>) {
+            return sizeof(uint32_t) + std::min(value.size(), MaxStringLength);
+         } else {
+            return ScalarSize;
+         }
+      }
+
+      template <typename T>
+      void Encode(std::byte*& out, const T& value) noexcept {
+         if constexpr (std::is_same_v<T, std::string_view>) {
+            const auto length = static_cast<uint32_t>(std::min(value.size(), MaxStringLength));
+            std::memcpy(out, &length, sizeof(length));
+            std::memcpy(out + sizeof(length), value.data(), length);
+            out += sizeof(length) + length;
+         } else {
+            uint64_t bits = 0;
+            if constexpr (std::is_same_v<T, const void*>) {
+               bits = reinterpret_cast<uintptr_t>(value);
+            } else if constexpr (std::is_same_v<T, bool>) {
+               bits = value ? 1 : 0;
+            } else {
+               static_assert(sizeof(T) == ScalarSize);
+               std::memcpy(&bits, &value, sizeof(bits));
+            }
+            std::memcpy(out, &bits, sizeof(bits));
+            out += ScalarSize;
+         }
+      }
+   }
+
+   // Writes call site descriptors and raw arguments into a memory mapped file, leaving all text
+   // formatting to the TritonLogDecode tool. Any thread may log; space is claimed with a single
+   // atomic add and entries become visible to the decoder once their size is stored. When the
+   // file is full further messages are counted and dropped. Open and Close must not race with
+   // threads that are logging.
+   class BinaryLog {
+    public:
+      static constexpr size_t DefaultCapacity = size_t{64} << 20;
+
+      constexpr BinaryLog() = default;
+
+      ~BinaryLog() {
+         Close();
+      }
+
+      BinaryLog(const BinaryLog&) = delete;
+      BinaryLog& operator=(const BinaryLog&) = delete;
+
+      // Starts a new file. Call sites that logged to an earlier one write their descriptors again.
+      bool Open(const char* path, size_t capacity = DefaultCapacity) {
+         Close();
+         if (capacity <= sizeof(FileHeader)) {
+            return false;
+         }
+
+         std::byte* view = Map(path, capacity);
+         if (!view) {
+            return false;
+         }
+
+         FileHeader header{};
+         std::memcpy(header.magic, Magic, sizeof(Magic));
+         header.version = Version;
+         header.headerSize = sizeof(FileHeader);
+         header.timestampFrequency = std::nano::den;
+         header.capacity = capacity;
+         std::memcpy(view, &header, sizeof(header));
+
+         this->capacity = capacity;
+         start = std::chrono::steady_clock::now();
+         cursor.store(sizeof(FileHeader), std::memory_order_relaxed);
+         dropped.store(0, std::memory_order_relaxed);
+         nextDescriptorId.store(1, std::memory_order_relaxed);
+         generation++;
+         base.store(view, std::memory_order_release);
+         return true;
+      }
+
+      void Close() {
+         std::byte* view = base.exchange(nullptr, std::memory_order_acq_rel);
+         if (!view) {
+            return;
+         }
+         const uint64_t used = std::min<uint64_t>(cursor.load(std::memory_order_relaxed), capacity);
+         Unmap(view, used);
+      }
+
+      [[nodiscard]] bool IsOpen() const noexcept {
+         return base.load(std::memory_order_acquire) != nullptr;
+      }
+
+      [[nodiscard]] uint64_t GetDroppedCount() const noexcept {
+         return dropped.load(std::memory_order_relaxed);
+      }
+
+      template <typename... Args>
+      void Write(CallSite& site, Level level, std::string_view format, const Args&... args) {
+         WriteNormalized(site, level, format, Detail::ToArg(args)...);
+      }
+
+    private:
+      template <typename... Args>
+      void WriteNormalized(CallSite& site,
+                           Level level,
+                           std::string_view format,
+                           const Args&... args) {
+         std::byte* view = base.load(std::memory_order_acquire);
+         if (!view) {
+            return;
+         }
+
+         // Reading generation is ordered by the acquire of base, which Open stores after it.
+         const uint64_t registration = site.registration.load(std::memory_order_acquire);
+         uint32_t id = static_cast<uint32_t>(registration);
+         if (registration >> 32 != generation) {
+            static constexpr std::array<ArgType, sizeof...(Args)> types{
+                Detail::TypeOf<Args>()...};
+            id = Register(view, site, registration, level, format, types.data(), types.size());
+            if (id == 0) {
+               return;
+            }
+         }
+
+         const size_t size =
+             AlignEntry(sizeof(EntryHeader) + (size_t{0} + ... + Detail::EncodedSize(args)));
+         std::byte* entry = Reserve(view, size);
+         if (!entry) {
+            return;
+         }
+
+         [[maybe_unused]] std::byte* out = entry + sizeof(EntryHeader);
+         (Detail::Encode(out, args), ...);
+         Commit(entry, size, EntryKind::Message, id);
+      }
+
+      // Writes site's descriptor and returns its id, or 0 if the file had no room for it, in which
+      // case the site stays unregistered and its message is dropped.
+      uint32_t Register(std::byte* view,
+                        CallSite& site,
+                        uint64_t registration,
+                        Level level,
+                        std::string_view format,
+                        const ArgType* types,
+                        size_t typeCount) {
+         const uint32_t id = nextDescriptorId.fetch_add(1, std::memory_order_relaxed);
+         const std::string_view file = site.file;
+
+         DescriptorPayload payload{};
+         payload.level = static_cast<uint8_t>(level);
+         payload.argCount = static_cast<uint8_t>(typeCount);
+         payload.fileLength = static_cast<uint16_t>(std::min<size_t>(file.size(), UINT16_MAX));
+         payload.formatLength = static_cast<uint16_t>(std::min<size_t>(format.size(), UINT16_MAX));
+         payload.line = site.line;
+
+         const size_t size = AlignEntry(sizeof(EntryHeader) + sizeof(payload) + typeCount +
+                                        payload.fileLength + payload.formatLength);
+         std::byte* entry = Reserve(view, size);
+         if (!entry) {
+            return 0;
+         }
+         std::byte* out = entry + sizeof(EntryHeader);
+         std::memcpy(out, &payload, sizeof(payload));
+         out += sizeof(payload);
+         std::memcpy(out, types, typeCount);
+         out += typeCount;
+         std::memcpy(out, file.data(), payload.fileLength);
+         out += payload.fileLength;
+         std::memcpy(out, format.data(), payload.formatLength);
+         Commit(entry, size, EntryKind::Descriptor, id);
+
+         // If another thread registered the same site for this file first, use its id. The
+         // duplicate descriptor is harmless, nothing will reference it.
+         const uint64_t registered = uint64_t{generation} << 32 | id;
+         while (!site.registration.compare_exchange_weak(
+             registration, registered, std::memory_order_acq_rel)) {
+            if (registration >> 32 == generation) {
+               return static_cast<uint32_t>(registration);
+            }
+         }
+         return id;
+      }
+
+      std::byte* Reserve(std::byte* view, size_t size) noexcept {
+         const uint64_t offset = cursor.fetch_add(size, std::memory_order_relaxed);
+         if (offset + size > capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+         }
+         return view + offset;
+      }
+
+      void Commit(std::byte* entry, size_t size, EntryKind kind, uint32_t id) noexcept {
+         auto* header = reinterpret_cast<EntryHeader*>(entry);
+         header->kind = kind;
+         header->descriptorId = id;
+         header->threadId = Pipeline::CurrentThreadId();
+         header->timestamp = static_cast<uint64_t>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now() - start)
+                 .count());
+         std::atomic_ref<uint32_t>(header->size)
+             .store(static_cast<uint32_t>(size), std::memory_order_release);
+      }
+
+      std::byte* Map(const char* path, size_t size) {
+#if defined(_WIN32)
+         file = CreateFileA(path,
+                            GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+         if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+         }
+         mapping = CreateFileMappingA(file,
+                                      nullptr,
+                                      PAGE_READWRITE,
+                                      static_cast<DWORD>(uint64_t{size} >> 32),
+                                      static_cast<DWORD>(size & 0xFFFFFFFF),
+                                      nullptr);
+         void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+         if (!view) {
+            if (mapping) {
+               CloseHandle(mapping);
+               mapping = nullptr;
+            }
+            CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+            return nullptr;
+         }
+         return static_cast<std::byte*>(view);
+#else
+         file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+         if (file < 0) {
+            return nullptr;
+         }
+         void* view = MAP_FAILED;
+         if (ftruncate(file, static_cast<off_t>(size)) == 0) {
+            view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+         }
+         if (view == MAP_FAILED) {
+            close(file);
+            file = -1;
+            return nullptr;
+         }
+         return static_cast<std::byte*>(view);
+#endif
+      }
+
+      // Releases the mapping and trims the file to what was actually written.
+      void Unmap(std::byte* view, uint64_t used) {
+#if defined(_WIN32)
+         UnmapViewOfFile(view);
+         CloseHandle(mapping);
+         mapping = nullptr;
+         LARGE_INTEGER end{};
+         end.QuadPart = static_cast<LONGLONG>(used);
+         if (SetFilePointerEx(file, end, nullptr, FILE_BEGIN)) {
+            SetEndOfFile(file);
+         }
+         CloseHandle(file);
+         file = INVALID_HANDLE_VALUE;
+#else
+         munmap(view, capacity);
+         std::ignore = ftruncate(file, static_cast<off_t>(used));
+         close(file);
+         file = -1;
+#endif
+      }
+
+      std::atomic<std::byte*> base{nullptr};
+      std::atomic<uint64_t> cursor{0};
+      std::atomic<uint64_t> dropped{0};
+      std::atomic<uint32_t> nextDescriptorId{1};
+      // Counts Opens; 0 is never current, so a new call site always registers.
+      uint32_t generation{0};
+      uint64_t capacity{0};
+      std::chrono::steady_clock::time_point start{};
+
+#if defined(_WIN32)
+      HANDLE file{INVALID_HANDLE_VALUE};
+      HANDLE mapping{nullptr};
+#else
+      int file{-1};
+#endif
+   };
+
+   inline BinaryLog binaryLog;
+}
+
+// Records a message into the binary log if it is open. The format uses {} placeholders that are
+// only expanded by the decoder, and must be a string literal.
+//    TX_BLOG(Trace, "Frame {} waited on fence {}", frameIndex, fenceValue);
+#define TX_BLOG(level, ...)                                                                        \
+   do {                                                                                            \
+      if (::Log::ShouldLog<::Log::Level::level>() && ::Log::Binary::binaryLog.IsOpen()) {          \
+         static ::Log::Binary::CallSite txBlogSite{__FILE__, static_cast<uint32_t>(__LINE__)};     \
+         ::Log::Binary::binaryLog.Write(txBlogSite, ::Log::Level::level, __VA_ARGS__);             \
+      }                                                                                            \
+   } while (false)
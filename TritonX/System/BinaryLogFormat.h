@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Log::Binary {
+
+   // On disk layout shared by the BinaryLog writer and the TritonLogDecode tool. Everything is
+   // little endian and every entry starts on an 8 byte boundary.
+   //
+   //    FileHeader
+   //    EntryHeader + payload, repeated until an entry with size 0 or the end of the file
+   //
+   // Descriptor entries describe one call site and are written once per file, the first time
+   // that site logs to it. Message entries reference a descriptor by id and carry only the raw
+   // arguments. Ids are only unique within one file.
+
+   inline constexpr char Magic[8] = {'T', 'X', 'B', 'L', 'O', 'G', '0', '1'};
+   inline constexpr uint32_t Version = 1;
+   inline constexpr size_t EntryAlignment = 8;
+
+   struct FileHeader {
+      char magic[8];
+      uint32_t version;
+      uint32_t headerSize;
+      uint64_t timestampFrequency; // Timestamp units per second.
+      uint64_t capacity;           // Total size of the mapping, including this header.
+   };
+
+   enum class EntryKind : uint16_t {
+      Descriptor = 1,
+      Message = 2
+   };
+
+   struct EntryHeader {
+      uint32_t size; // Whole entry including this header, padded. Written last.
+      EntryKind kind;
+      uint16_t reserved;
+      uint32_t descriptorId;
+      uint32_t threadId;
+      uint64_t timestamp;
+   };
+
+   // Follows an EntryHeader of kind Descriptor, then argCount ArgType bytes, the file name and
+   // the format string, neither of them null terminated.
+   struct DescriptorPayload {
+      uint8_t level;
+      uint8_t argCount;
+      uint16_t fileLength;
+      uint16_t formatLength;
+      uint16_t reserved;
+      uint32_t line;
+   };
+
+   // Message arguments are stored back to back in call order. Scalars take 8 bytes, strings a
+   // uint32_t length followed by that many bytes.
+   enum class ArgType : uint8_t {
+      Bool = 1,
+      Int64,
+      UInt64,
+      Double,
+      Pointer,
+      String
+   };
+
+   inline constexpr size_t ScalarSize = 8;
+   inline constexpr size_t MaxStringLength = 1024;
+
+   constexpr size_t AlignEntry(size_t size) noexcept {
+      return (size + EntryAlignment - 1) & ~(EntryAlignment - 1);
+   }
+
+   static_assert(sizeof(FileHeader) % EntryAlignment == 0);
+   static_assert(sizeof(EntryHeader) % EntryAlignment == 0);
+   static_assert(sizeof(DescriptorPayload) == 12);
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+// Numbers, strings and pointers never go through std::format, so standard libraries without it
+// (libstdc++ before 13) still build the logger. Only other formattable types need it.
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+#include "System/LogRate.h"
+
+namespace Log {
+
+   // Encodes UTF-16 (or UTF-32 where wchar_t is 32 bits) as UTF-8 into out, never writing more
+   // than capacity bytes and never splitting a code point. Returns the number of bytes written.
+   inline size_t EncodeUtf8(std::wstring_view text, char* out, size_t capacity) noexcept {
+      size_t written = 0;
+      for (size_t i = 0; i < text.size(); i++) {
+         auto c = static_cast<uint32_t>(text[i]);
+         // Combine UTF-16 surrogate pairs where wchar_t is 16 bits.
+         if (c >= 0xD800 && c <= 0xDBFF && i + 1 < text.size()) {
+            const auto low = static_cast<uint32_t>(text[i + 1]);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+               c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+               i++;
+            }
+         }
+
+         char bytes[4];
+         size_t count = 0;
+         if (c < 0x80) {
+            bytes[count++] = static_cast<char>(c);
+         } else if (c < 0x800) {
+            bytes[count++] = static_cast<char>(0xC0 | (c >> 6));
+            bytes[count++] = static_cast<char>(0x80 | (c & 0x3F));
+         } else if (c < 0x10000) {
+            bytes[count++] = static_cast<char>(0xE0 | (c >> 12));
+            bytes[count++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            bytes[count++] = static_cast<char>(0x80 | (c & 0x3F));
+         } else {
+            bytes[count++] = static_cast<char>(0xF0 | (c >> 18));
+            bytes[count++] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            bytes[count++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            bytes[count++] = static_cast<char>(0x80 | (c & 0x3F));
+         }
+
+         if (written + count > capacity) {
+            break;
+         }
+         std::copy_n(bytes, count, out + written);
+         written += count;
+      }
+      return written;
+   }
+
+   // UTF-8 text of bounded length that lives entirely inside the object. Appends past the end are
+   // truncated rather than growing, so building a log line never touches the heap.
+   template <size_t Capacity>
+   class FixedString {
+    public:
+      void Clear() noexcept {
+         size = 0;
+      }
+
+      [[nodiscard]] std::string_view View() const noexcept {
+         return {data, size};
+      }
+
+      void Append(std::string_view text) noexcept {
+         const size_t count = std::min(text.size(), Capacity - size);
+         std::copy_n(text.data(), count, data + size);
+         size += count;
+      }
+
+      void Append(std::wstring_view text) noexcept {
+         size += EncodeUtf8(text, data + size, Capacity - size);
+      }
+
+      // Writes value as std::format's "{}" would: integers in decimal, floating point in the
+      // shortest form that reads back exactly, and pointers in hex after 0x.
+      template <typename T>
+      void AppendNumber(T value) noexcept {
+         // Holds any integer, the shortest form of any floating point value, or a pointer.
+         char buffer[64];
+         std::to_chars_result result;
+         if constexpr (std::is_pointer_v<T>) {
+            buffer[0] = '0';
+            buffer[1] = 'x';
+            result = std::to_chars(
+                buffer + 2, std::end(buffer), reinterpret_cast<uintptr_t>(value), 16);
+         } else {
+            result = std::to_chars(buffer, std::end(buffer), value);
+         }
+         Append(std::string_view{buffer, result.ptr});
+      }
+
+#if defined(__cpp_lib_format)
+      template <typename... Args>
+      void Format(std::format_string<Args...> format, Args&&... args) {
+         const auto result = std::format_to_n(data + size,
+                                              static_cast<std::ptrdiff_t>(Capacity - size),
+                                              format,
+                                              std::forward<Args>(args)...);
+         size = static_cast<size_t>(result.out - data);
+      }
+#endif
+
+    private:
+      char data[Capacity];
+      size_t size{0};
+   };
+
+   // Arithmetic types std::to_chars writes, which leaves out bool and the character types.
+   template <typename T>
+   concept Number = std::floating_point<T> ||
+                    (std::integral<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+                     !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+                     !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>);
+
+#if defined(__cpp_lib_format)
+   template <typename T>
+   concept StdFormattable = std::is_default_constructible_v<std::formatter<T, char>>;
+#else
+   template <typename T>
+   concept StdFormattable = false;
+#endif
+
+   // Appends the text form of value. Strings of either width, characters, numbers, pointers and
+   // anything else std::format understands are written without allocating. Other types fall back
+   // to their wostream operator<<, which does allocate.
+   template <size_t Capacity, typename T>
+   void AppendValue(FixedString<Capacity>& out, const T& value) {
+      using U = std::remove_cvref_t<T>;
+      if constexpr (std::is_same_v<U, Suppressed>) {
+         if (value.count > 0) {
+            out.Append(std::string_view{"["});
+            out.AppendNumber(value.count);
+            out.Append(std::string_view{" suppressed] "});
+         }
+      } else if constexpr (std::is_convertible_v<const U&, std::wstring_view> &&
+                           !std::is_null_pointer_v<U>) {
+         if constexpr (std::is_pointer_v<U>) {
+            if (!value) {
+               out.Append(std::string_view{"(null)"});
+               return;
+            }
+         }
+         out.Append(std::wstring_view{value});
+      } else if constexpr (std::is_convertible_v<const U&, std::string_view> &&
+                           !std::is_null_pointer_v<U>) {
+         if constexpr (std::is_pointer_v<U>) {
+            if (!value) {
+               out.Append(std::string_view{"(null)"});
+               return;
+            }
+         }
+         out.Append(std::string_view{value});
+      } else if constexpr (std::is_same_v<U, wchar_t>) {
+         out.Append(std::wstring_view{&value, 1});
+      } else if constexpr (std::is_same_v<U, char>) {
+         out.Append(std::string_view{&value, 1});
+      } else if constexpr (std::is_same_v<U, bool>) {
+         out.Append(std::string_view{value ? "true" : "false"});
+      } else if constexpr (std::is_enum_v<U>) {
+         out.AppendNumber(static_cast<std::underlying_type_t<U>>(value));
+      } else if constexpr (std::is_pointer_v<U>) {
+         out.AppendNumber(static_cast<const void*>(value));
+      } else if constexpr (Number<U>) {
+         out.AppendNumber(value);
+      } else if constexpr (StdFormattable<U>) {
+         out.Format("{}", value);
+      } else {
+         std::wostringstream stream;
+         stream << value;
+         out.Append(std::wstring_view{stream.view()});
+      }
+   }
+}
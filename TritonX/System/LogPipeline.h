@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "System/LogRecord.h"
+#include "System/LogSinks.h"
+#include "System/MpscQueue.h"
+
+namespace Log {
+
+   // What a producer does when the queue is full.
+   enum class OverflowPolicy {
+      // Count the message as dropped and return immediately. Never stalls the caller.
+      Drop,
+      // Spin until the consumer frees a slot. Loses nothing but can stall hot threads.
+      Block
+   };
+
+   // Moves log lines off the calling thread. Producers copy their message into a fixed size
+   // Record in a bounded MPSC ring; a background thread formats records and fans them out to the
+   // registered sinks.
+   class Pipeline {
+    public:
+      static constexpr size_t DefaultCapacity = 4096;
+
+      explicit Pipeline(size_t capacity = DefaultCapacity) :
+          queue(capacity), start(std::chrono::steady_clock::now()) {
+#if defined(_WIN32)
+         sinks.push_back(std::make_unique<DebuggerSink>());
+#else
+         sinks.push_back(std::make_unique<StderrSink>());
+#endif
+         consumer = std::thread([this]() { Run(); });
+      }
+
+      ~Pipeline() {
+         running.store(false, std::memory_order_release);
+         consumer.join();
+      }
+
+      Pipeline(const Pipeline&) = delete;
+      Pipeline& operator=(const Pipeline&) = delete;
+
+      void SetOverflowPolicy(OverflowPolicy policy) noexcept {
+         overflowPolicy.store(policy, std::memory_order_relaxed);
+      }
+
+      void AddSink(std::unique_ptr<Sink> sink) {
+         const std::lock_guard lock(sinkMutex);
+         sinks.push_back(std::move(sink));
+      }
+
+      void ClearSinks() {
+         const std::lock_guard lock(sinkMutex);
+         sinks.clear();
+      }
+
+      // Total messages discarded under OverflowPolicy::Drop.
+      uint64_t GetDroppedCount() const noexcept {
+         return dropped.load(std::memory_order_relaxed);
+      }
+
+      // Copies text into the queue. Returns false if the message was dropped.
+      bool Submit(Level level, std::string_view text) {
+         const uint64_t timestamp = Now();
+         const uint32_t threadId = CurrentThreadId();
+
+         const auto fill = [&](Record& record) {
+            record.level = level;
+            record.threadId = threadId;
+            record.timestamp = timestamp;
+            record.length = static_cast<uint32_t>(std::min(text.size(), Record::MaxLength));
+            std::copy_n(text.data(), record.length, record.text);
+         };
+
+         while (!queue.TryPush(fill)) {
+            if (overflowPolicy.load(std::memory_order_relaxed) == OverflowPolicy::Drop) {
+               dropped.fetch_add(1, std::memory_order_relaxed);
+               return false;
+            }
+            std::this_thread::yield();
+         }
+         return true;
+      }
+
+      // Blocks until everything submitted before the call, from any thread, has reached the
+      // sinks. Records are written in the order their queue slots were claimed, so once the writes
+      // catch up with the slots claimed so far, every earlier record has been written, even one
+      // another thread was still copying in when this was called.
+      void Flush() {
+         const uint64_t target = queue.GetPushCount();
+         while (written.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+         }
+      }
+
+      // Small sequential id, cheaper to print and read than std::thread::id.
+      static uint32_t CurrentThreadId() noexcept {
+         static std::atomic<uint32_t> next{0};
+         thread_local const uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+         return id;
+      }
+
+    private:
+      uint64_t Now() const noexcept {
+         return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now() - start)
+                                          .count());
+      }
+
+      void Run() {
+         uint64_t reportedDrops = 0;
+         for (;;) {
+            // Read the flag before draining so nothing submitted before shutdown is lost.
+            const bool stopping = !running.load(std::memory_order_acquire);
+
+            size_t drained = 0;
+            {
+               const std::lock_guard lock(sinkMutex);
+               while (queue.TryPop([&](Record& record) { Write(record); })) {
+                  drained++;
+               }
+
+               const uint64_t drops = dropped.load(std::memory_order_relaxed);
+               if (drops != reportedDrops) {
+                  WriteDropNotice(drops - reportedDrops);
+                  reportedDrops = drops;
+               }
+
+               if (drained > 0) {
+                  for (auto& sink : sinks) {
+                     sink->Flush();
+                  }
+               }
+            }
+            written.fetch_add(drained, std::memory_order_release);
+
+            if (stopping) {
+               return;
+            }
+            if (drained == 0) {
+               std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+         }
+      }
+
+      void Write(const Record& record) {
+         char prefix[32] = {};
+         const uint64_t micros = record.timestamp / 1000;
+         std::snprintf(prefix,
+                       std::size(prefix),
+                       "[%6llu.%06llu] ",
+                       static_cast<unsigned long long>(micros / 1000000),
+                       static_cast<unsigned long long>(micros % 1000000));
+
+         line.clear();
+         line.append(prefix);
+         line.append(LevelName(record.level));
+         line.append(record.Text());
+         line.push_back('\n');
+
+         for (auto& sink : sinks) {
+            sink->Write(record, line);
+         }
+      }
+
+      void WriteDropNotice(uint64_t count) {
+         Record notice{};
+         notice.level = Level::Warn;
+         notice.threadId = CurrentThreadId();
+         notice.timestamp = Now();
+         const int length = std::snprintf(notice.text,
+                                          Record::MaxLength,
+                                          "Log queue full, dropped %llu messages",
+                                          static_cast<unsigned long long>(count));
+         notice.length = length > 0 ? static_cast<uint32_t>(length) : 0;
+         Write(notice);
+      }
+
+      TX::MpscQueue<Record> queue;
+      const std::chrono::steady_clock::time_point start;
+
+      std::atomic<OverflowPolicy> overflowPolicy{OverflowPolicy::Drop};
+      std::atomic<uint64_t> dropped{0};
+      std::atomic<uint64_t> written{0};
+
+      // Only contended when sinks are reconfigured.
+      std::mutex sinkMutex;
+      std::vector<std::unique_ptr<Sink>> sinks;
+      std::string line;
+
+      std::atomic<bool> running{true};
+      std::thread consumer;
+   };
+
+   inline Pipeline& GetPipeline() {
+      static Pipeline pipeline;
+      return pipeline;
+   }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Log {
+
+   // Per call site budget of messages per second. Constant initialized, so a function local
+   // static of this type costs no initialization guard. Thread safe; under contention the budget
+   // is approximate, which is fine for keeping sinks from flooding.
+   class RateLimiter {
+    public:
+      constexpr RateLimiter() = default;
+
+      // Returns true if this message fits in the current one second window. When it does,
+      // suppressed receives how many messages were rejected since the last one let through.
+      bool Allow(uint32_t maxPerSecond, uint64_t& suppressed) noexcept {
+         constexpr uint64_t window = std::nano::den;
+         const auto now = static_cast<uint64_t>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+                 .count());
+
+         uint64_t start = windowStart.load(std::memory_order_relaxed);
+         if (now - start >= window &&
+             windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            allowedInWindow.store(0, std::memory_order_relaxed);
+         }
+
+         if (allowedInWindow.fetch_add(1, std::memory_order_relaxed) < maxPerSecond) {
+            suppressed = rejected.exchange(0, std::memory_order_relaxed);
+            return true;
+         }
+         rejected.fetch_add(1, std::memory_order_relaxed);
+         return false;
+      }
+
+    private:
+      std::atomic<uint64_t> windowStart{0};
+      std::atomic<uint32_t> allowedInWindow{0};
+      std::atomic<uint64_t> rejected{0};
+   };
+
+   // Per call site 1-in-N sampler. The first call is always let through.
+   class Sampler {
+    public:
+      constexpr Sampler() = default;
+
+      bool Allow(uint32_t n) noexcept {
+         return n <= 1 || counter.fetch_add(1, std::memory_order_relaxed) % n == 0;
+      }
+
+    private:
+      std::atomic<uint64_t> counter{0};
+   };
+
+   // Streamed in front of a rate limited message to report what was dropped before it.
+   struct Suppressed {
+      uint64_t count;
+   };
+}
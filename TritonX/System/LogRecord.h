@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Log {
+
+   enum class Level {
+      Trace = 0,
+      Debug,
+      Info,
+      Warn,
+      Error
+   };
+
+   [[nodiscard]] constexpr std::string_view LevelName(Level level) noexcept {
+      switch (level) {
+         case Level::Trace:
+            return "Trace ";
+         case Level::Debug:
+            return "Debug ";
+         case Level::Info:
+            return "Info  ";
+         case Level::Warn:
+            return "Warn  ";
+         case Level::Error:
+            return "Error ";
+      }
+      return "Unknown";
+   }
+
+   // One fully assembled UTF-8 log line as it travels from the logging thread to the consumer
+   // thread. Fixed size so the queue never allocates; longer messages are truncated. Sized so a
+   // record plus its queue sequence number fill exactly eight cache lines.
+   struct Record {
+      static constexpr size_t MaxLength = 480;
+
+      Level level;
+      uint32_t threadId;
+      uint64_t timestamp; // Nanoseconds since the pipeline started.
+      uint32_t length;
+      char text[MaxLength];
+
+      [[nodiscard]] std::string_view Text() const noexcept {
+         return {text, length};
+      }
+   };
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#if defined(_WIN32)
+#include <debugapi.h>
+#include <stringapiset.h>
+#endif
+
+#include "System/LogRecord.h"
+
+namespace Log {
+
+   // Destination for formatted log lines. Sinks are only ever called from the pipeline's consumer
+   // thread, so implementations need no synchronization of their own.
+   class Sink {
+    public:
+      virtual ~Sink() = default;
+
+      // line is fully formatted UTF-8 and ends with a newline.
+      virtual void Write(const Record& record, std::string_view line) = 0;
+      virtual void Flush() {
+      }
+   };
+
+   // Writes UTF-8 to an already open C stream.
+   class StreamSink : public Sink {
+    public:
+      explicit StreamSink(std::FILE* stream) : stream(stream) {
+      }
+
+      void Write(const Record&, std::string_view line) override {
+         std::fwrite(line.data(), 1, line.size(), stream);
+      }
+
+      void Flush() override {
+         std::fflush(stream);
+      }
+
+    protected:
+      std::FILE* stream;
+   };
+
+   class StderrSink : public StreamSink {
+    public:
+      StderrSink() : StreamSink(stderr) {
+      }
+   };
+
+   // Appends UTF-8 lines to a file. Silently does nothing if the file cannot be opened.
+   class FileSink : public StreamSink {
+    public:
+      explicit FileSink(const char* path) : StreamSink(nullptr) {
+#if defined(_MSC_VER)
+         if (fopen_s(&stream, path, "ab") != 0) {
+            stream = nullptr;
+         }
+#else
+         stream = std::fopen(path, "ab");
+#endif
+      }
+
+      ~FileSink() override {
+         if (stream) {
+            std::fclose(stream);
+         }
+      }
+
+      FileSink(const FileSink&) = delete;
+      FileSink& operator=(const FileSink&) = delete;
+
+      void Write(const Record& record, std::string_view line) override {
+         if (stream) {
+            StreamSink::Write(record, line);
+         }
+      }
+
+      void Flush() override {
+         if (stream) {
+            StreamSink::Flush();
+         }
+      }
+   };
+
+#if defined(_WIN32)
+   // Visual Studio output window. The debugger API wants UTF-16, so lines are converted here on
+   // the consumer thread rather than on the logging threads.
+   class DebuggerSink : public Sink {
+    public:
+      void Write(const Record&, std::string_view line) override {
+         const int length = MultiByteToWideChar(
+             CP_UTF8, 0, line.data(), static_cast<int>(line.size()), nullptr, 0);
+         buffer.resize(static_cast<size_t>(length));
+         MultiByteToWideChar(
+             CP_UTF8, 0, line.data(), static_cast<int>(line.size()), buffer.data(), length);
+         OutputDebugStringW(buffer.c_str());
+      }
+
+    private:
+      std::wstring buffer;
+   };
+#endif
+}
@@ -0,0 +1,109 @@
+//
+// MpscQueue.h - Bounded lock free multi producer, single consumer queue
+//
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace TX {
+
+   // Bounded multi producer / single consumer ring. Every slot carries a sequence number that
+   // tells producers and the consumer whose turn it is, so neither side ever takes a lock. Values
+   // are filled and consumed in place to avoid copying whole records through the queue. All
+   // memory is allocated once up front.
+   template <typename T>
+   class MpscQueue {
+    public:
+      explicit MpscQueue(size_t capacity) :
+          capacity(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)), mask(this->capacity - 1),
+          cells(std::make_unique<Cell[]>(this->capacity)) {
+         for (size_t i = 0; i < this->capacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+         }
+      }
+
+      MpscQueue(const MpscQueue&) = delete;
+      MpscQueue& operator=(const MpscQueue&) = delete;
+
+      size_t Capacity() const noexcept {
+         return capacity;
+      }
+
+      // Slots claimed by TryPush so far, including ones still being filled. Values are consumed
+      // in the order their slots were claimed.
+      size_t GetPushCount() const noexcept {
+         return enqueuePosition.load(std::memory_order_relaxed);
+      }
+
+      // Claims a slot and calls fill(T&) on it. Returns false without calling fill if the queue
+      // is full. Safe to call from any number of threads.
+      template <typename TFill>
+      bool TryPush(TFill&& fill) {
+         size_t position = enqueuePosition.load(std::memory_order_relaxed);
+         Cell* cell = nullptr;
+         for (;;) {
+            cell = &cells[position & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+               if (enqueuePosition.compare_exchange_weak(
+                       position, position + 1, std::memory_order_relaxed)) {
+                  break;
+               }
+            } else if (diff < 0) {
+               return false;
+            } else {
+               position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+         }
+
+         fill(cell->value);
+         cell->sequence.store(position + 1, std::memory_order_release);
+         return true;
+      }
+
+      // Calls consume(T&) on the oldest committed value and releases its slot. Returns false if
+      // nothing is ready. Must only be called from the single consumer thread.
+      template <typename TConsume>
+      bool TryPop(TConsume&& consume) {
+         return TryPopIf([](const T&) { return true; }, std::forward<TConsume>(consume));
+      }
+
+      // As TryPop, but leaves the oldest value queued unless ready(const T&) accepts it.
+      template <typename TReady, typename TConsume>
+      bool TryPopIf(TReady&& ready, TConsume&& consume) {
+         Cell& cell = cells[dequeuePosition & mask];
+         const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+         if (sequence != dequeuePosition + 1 || !ready(std::as_const(cell.value))) {
+            return false;
+         }
+
+         consume(cell.value);
+         cell.sequence.store(dequeuePosition + capacity, std::memory_order_release);
+         dequeuePosition++;
+         return true;
+      }
+
+    private:
+      static constexpr size_t CacheLineSize = 64;
+
+      struct alignas(CacheLineSize) Cell {
+         std::atomic<size_t> sequence;
+         T value;
+      };
+
+      const size_t capacity;
+      const size_t mask;
+      std::unique_ptr<Cell[]> cells;
+
+      alignas(CacheLineSize) std::atomic<size_t> enqueuePosition{0};
+      alignas(CacheLineSize) size_t dequeuePosition{0};
+   };
+}
@@ -0,0 +1,173 @@
+//
+// Simulation.h - Fixed step update loop that can run inline or on its own thread
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "StepTimer.h"
+#include "TripleBuffer.h"
+
+namespace TX {
+
+   // Output of one simulation step. Treated as immutable once published.
+   struct SimulationState {
+      uint32_t frame;
+      double totalSeconds;
+   };
+
+   inline SimulationState Interpolate(const SimulationState& previous,
+                                      const SimulationState& current,
+                                      double alpha) noexcept {
+      return SimulationState{
+          .frame = current.frame,
+          .totalSeconds = std::lerp(previous.totalSeconds, current.totalSeconds, alpha)};
+   }
+
+   // What the simulation hands to the renderer after each Tick: the last two states plus enough
+   // timing information to compute an interpolation alpha on the consuming thread.
+   struct SimulationFrame {
+      SimulationState previous;
+      SimulationState current;
+      uint64_t publishedAt;    // Clock counts when this frame was published.
+      uint64_t leftOverTicks;  // StepTimer ticks not yet simulated at publish time.
+      uint64_t targetTicks;    // Fixed step length in StepTimer ticks.
+   };
+
+   // Owns the StepTimer and the simulation state. In inline mode the owner calls Tick() from its
+   // own loop. In threaded mode Start() spawns a thread that runs the fixed step loop on its own
+   // so presentation stalls cannot eat into the simulation budget. Either way results are
+   // published through a TripleBuffer and read with Latest() by exactly one consumer thread,
+   // which also reads the clock, so threaded mode needs a clock whose Now() is thread safe.
+   template <typename TClock = DefaultClock>
+   class BasicSimulation {
+    public:
+      using Timer = BasicStepTimer<TClock>;
+      using UpdateFunction = std::function<SimulationState(const Timer&, const SimulationState&)>;
+
+      explicit BasicSimulation(UpdateFunction update, TClock clock = TClock{}) :
+          update(std::move(update)), timer(clock) {
+      }
+
+      ~BasicSimulation() {
+         Stop();
+      }
+
+      BasicSimulation(const BasicSimulation&) = delete;
+      BasicSimulation& operator=(const BasicSimulation&) = delete;
+
+      // Configure before Start(), or at any time in inline mode.
+      Timer& GetTimer() noexcept {
+         return timer;
+      }
+
+      bool IsThreaded() const noexcept {
+         return worker.joinable();
+      }
+
+      // Advance the simulation from the calling thread. Only valid while not threaded.
+      void Tick() {
+         timer.Tick([&]() { Step(); });
+         Publish();
+      }
+
+      void Start() {
+         if (worker.joinable()) {
+            return;
+         }
+         timer.ResetElapsedTime();
+         running.store(true, std::memory_order_relaxed);
+         worker = std::thread([this]() { Run(); });
+      }
+
+      void Stop() {
+         if (!worker.joinable()) {
+            return;
+         }
+         running.store(false, std::memory_order_relaxed);
+         worker.join();
+         timer.ResetElapsedTime();
+      }
+
+      // Consumer side: the most recently published frame.
+      const SimulationFrame& Latest() noexcept {
+         return frames.Read();
+      }
+
+      // Consumer side: how far past frame.current the clock is now, as a fraction of a step.
+      // Accounts for time spent between publishing and rendering, so it stays correct when the
+      // simulation runs on another thread.
+      double GetInterpolationAlpha(const SimulationFrame& frame) const {
+         if (frame.targetTicks == 0) {
+            return 1.0;
+         }
+         const auto& clock = timer.GetClock();
+         const uint64_t now = clock.Now();
+         const uint64_t sincePublish = now > frame.publishedAt ? now - frame.publishedAt : 0;
+         const double ticks =
+             static_cast<double>(frame.leftOverTicks) +
+             static_cast<double>(sincePublish) * Timer::TicksPerSecond / clock.Frequency();
+         return std::min(ticks / static_cast<double>(frame.targetTicks), 1.0);
+      }
+
+    private:
+      void Step() {
+         previous = current;
+         current = update(timer, current);
+      }
+
+      void Publish() {
+         auto& frame = frames.Back();
+         frame.previous = previous;
+         frame.current = current;
+         frame.publishedAt = timer.GetClock().Now();
+         frame.leftOverTicks = timer.GetLeftOverTicks();
+         frame.targetTicks = timer.GetTargetElapsedTicks();
+         frames.Publish();
+      }
+
+      void Run() {
+         using namespace std::chrono;
+
+         while (running.load(std::memory_order_relaxed)) {
+            Tick();
+
+            // Sleep through most of the wait for the next step and spin the last millisecond,
+            // since OS sleeps overshoot by about that much.
+            const uint64_t target = timer.GetTargetElapsedTicks();
+            const uint64_t leftOver = timer.GetLeftOverTicks();
+            const uint64_t remaining = target > leftOver ? target - leftOver : 0;
+            constexpr uint64_t spinTicks = Timer::TicksPerSecond / 1000;
+            if (remaining > spinTicks) {
+               std::this_thread::sleep_for(
+                   duration_cast<nanoseconds>(duration<double>(
+                       Timer::TicksToSeconds(remaining - spinTicks))));
+            } else {
+               std::this_thread::yield();
+            }
+         }
+      }
+
+      UpdateFunction update;
+      Timer timer;
+
+      // Only touched by whichever thread is running Tick().
+      SimulationState previous{};
+      SimulationState current{};
+
+      TripleBuffer<SimulationFrame> frames;
+
+      std::atomic<bool> running{false};
+      std::thread worker;
+   };
+
+   using Simulation = BasicSimulation<>;
+}
@@ -2,6 +2,7 @@
 
 #include "Graphics/Context.h"
 #include "Logger.h"
+#include "System/BinaryLog.h"
 
 #pragma warning(disable : 4061)
 
@@ -21,12 +22,18 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance,
                     _In_ const PWSTR lpCmdLine,
                     _In_ int nCmdShow) {
    UNREFERENCED_PARAMETER(hPrevInstance);
-   UNREFERENCED_PARAMETER(lpCmdLine);
 
    Log::LogManager::getInstance().setMinLevel(Log::Level::Debug);
 
    Log::info << L"Logger Configured" << std::endl;
 
+   // -trace records high rate frame loop tracing, decode it with TritonLogDecode.
+   if (lpCmdLine && wcsstr(lpCmdLine, L"-trace")) {
+      if (!Log::Binary::binaryLog.Open("TritonX.blog")) {
+         Log::warn << L"Could not open TritonX.blog for tracing" << std::endl;
+      }
+   }
+
    if (!DirectX::XMVerifyCPUSupport())
       return 1;
 
@@ -102,6 +109,7 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance,
    }
 
    context.reset();
+   Log::Binary::binaryLog.Close();
 
    return static_cast<int>(msg.wParam);
 }
@@ -0,0 +1,71 @@
+//
+// TripleBuffer.h - Wait-free single producer / single consumer value exchange
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace TX {
+   // Hands whole values from one writer thread to one reader thread without locks or tearing.
+   // The writer fills Back() and calls Publish(); the reader calls Read() and always sees the most
+   // recently published value. Neither side ever blocks the other, and intermediate values are
+   // skipped if the writer outpaces the reader.
+   template <typename T>
+   class TripleBuffer {
+    public:
+      TripleBuffer() = default;
+
+      explicit TripleBuffer(const T& initial) : buffers{initial, initial, initial} {
+      }
+
+      TripleBuffer(const TripleBuffer&) = delete;
+      TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+      // Writer side: the slot to fill before calling Publish().
+      T& Back() noexcept {
+         return buffers[back];
+      }
+
+      // Writer side: make Back() visible to the reader and receive a fresh slot to write into.
+      void Publish() noexcept {
+         const uint8_t previous = middle.exchange(back | DirtyBit, std::memory_order_acq_rel);
+         back = previous & IndexMask;
+      }
+
+      // Reader side: returns true if a newer value has been published since the last call.
+      bool Update() noexcept {
+         if ((middle.load(std::memory_order_relaxed) & DirtyBit) == 0) {
+            return false;
+         }
+         const uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+         front = previous & IndexMask;
+         return true;
+      }
+
+      // Reader side: latches the newest value and returns it. The reference stays valid until the
+      // next Update() or Read() on the reader thread.
+      const T& Read() noexcept {
+         Update();
+         return buffers[front];
+      }
+
+      // Reader side: the value latched by the last Update() or Read().
+      const T& Front() const noexcept {
+         return buffers[front];
+      }
+
+    private:
+      static constexpr uint8_t IndexMask = 0x3;
+      static constexpr uint8_t DirtyBit = 0x4;
+
+      std::array<T, 3> buffers{};
+
+      // Each index is owned by exactly one thread; only the middle slot is shared.
+      uint8_t back{0};
+      std::atomic<uint8_t> middle{1};
+      uint8_t front{2};
+   };
+}
@@ -1,5 +1,14 @@
 #pragma once
 
+#include <array>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+// Portable translation units (Renderer and the null backend) also build off Windows, where only
+// the standard library part of this header applies.
+#if defined(_WIN32)
 #include <winsdkver.h>
 #ifndef _WIN32_WINNT
 #define _WIN32_WINNT 0x0A00
@@ -33,9 +42,6 @@
 #include <wrl/client.h>
 #include <wrl/event.h>
 
-#include <iostream>
-#include <functional>
-
 // DirectX 12 specific headers.
 #include <d3d12.h>
 #include <dxgi1_6.h>
@@ -47,6 +53,5 @@
 #include <DirectXMath.h>
 
 #include <comdef.h>
-#include <array>
-#include <sstream>
-#include "d3dx12.h"
\ No newline at end of file
+#include "d3dx12.h"
+#endif